@@ -0,0 +1,203 @@
+#ifndef BITSTREAM_H
+#define BITSTREAM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// 패킹된 비트열 입출력 (crc_encoder / crc_decoder 공용)
+//
+// 비트는 바이트 안에서 MSB 우선으로 패킹되고, 값은 64비트 워드의 최상위 비트부터 채우는
+// left-aligned 형식으로 주고받는다. 쓰기와 읽기 모두 64비트 누산기를 두고
+// 워드 단위로 메모리에 접근해서, 임의 길이의 코드워드를 비트 단위 루프 없이 붙이고 떼어낸다.
+//
+// 인코더 출력은 [패딩 크기 1바이트][패딩 0비트][코드워드 ...] 형식이고,
+// 패딩은 전체 길이가 16비트의 배수가 되도록 정해진다.
+
+// 코드워드 전체 비트 수에 맞는 패딩 비트 수
+static inline int bits_pad_size(uint64_t code_bits)
+{
+    return (int)((16 - code_bits % 16) % 16);
+}
+
+// 인코더 출력 앞부분(패딩 크기 바이트 + 패딩)을 header에 쓰고 바이트 수 반환
+// 패딩의 마지막 pad % 8 비트는 첫 코드워드와 같은 바이트에 들어가므로 header에 포함하지 않음
+static inline size_t bits_pad_prefix(uint8_t header[2], int pad)
+{
+    header[0] = (uint8_t)pad;
+    header[1] = 0;
+    return (size_t)(8 + pad) / 8;
+}
+
+// 인코더 출력에서 첫 코드워드가 시작하는 비트 위치
+static inline uint64_t bits_data_start(const uint8_t *data, size_t size)
+{
+    return size > 0 ? 8 + (uint64_t)data[0] : 0;
+}
+
+static inline uint64_t load_be64(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return __builtin_bswap64(v);
+}
+
+// data의 bit_offset 비트부터 nbits(<= 64) 비트를 left-aligned 워드로 읽기 (임의 위치 접근)
+static inline uint64_t load_bits(const uint8_t *data, uint64_t bit_offset, int nbits)
+{
+    if (nbits <= 0) return 0;
+    const uint8_t *p = data + (bit_offset >> 3);
+    int shift = (int)(bit_offset & 7);
+    int nbytes = (shift + nbits + 7) >> 3; // 걸쳐 있는 바이트 수 (1 ~ 9)
+    uint64_t v = 0;
+    for (int i = 0; i < nbytes && i < 8; i++) {
+        v |= (uint64_t)p[i] << (56 - 8 * i);
+    }
+    v <<= shift;
+    if (nbytes > 8) v |= (uint64_t)p[8] >> (8 - shift);
+    return v & (~0ULL << (64 - nbits)); // 상위 nbits 비트만 남김
+}
+
+// 패킹된 비트를 메모리 버퍼에 모으는 구조체
+typedef struct {
+    uint8_t *buf;   // 출력 버퍼 (충분한 크기를 호출자가 보장)
+    size_t len;     // 버퍼에 찬 바이트 수
+    uint64_t acc;   // 아직 바이트로 내보내지 않은 비트 (left-aligned)
+    int nbits;      // acc에 있는 비트 수 (< 64)
+} BitWriter;
+
+// v의 상위 n(<= 64) 비트를 출력에 추가
+static inline void put_bits(BitWriter *w, uint64_t v, int n)
+{
+    if (n <= 0) return;
+    w->acc |= v >> w->nbits;
+    if (w->nbits + n < 64) {
+        w->nbits += n;
+        return;
+    }
+    uint64_t word = __builtin_bswap64(w->acc); // 누산기가 차면 워드 하나로 내보냄
+    memcpy(w->buf + w->len, &word, 8);
+    w->len += 8;
+    int used = 64 - w->nbits; // v에서 사용한 비트 수
+    w->acc = used < 64 ? v << used : 0;
+    w->nbits = w->nbits + n - 64;
+}
+
+// 남은 비트를 0으로 채워 바이트 단위로 기록
+static inline void finish_bits(BitWriter *w)
+{
+    for (int i = 0; i < w->nbits; i += 8) {
+        w->buf[w->len++] = (uint8_t)(w->acc >> (56 - i));
+    }
+    w->acc = 0;
+    w->nbits = 0;
+}
+
+// 다 찬 바이트만 기록하고 8비트 미만은 acc 에 남김 (이어서 쓸 스트림용)
+static inline void flush_bytes(BitWriter *w)
+{
+    for (; w->nbits >= 8; w->nbits -= 8) {
+        w->buf[w->len++] = (uint8_t)(w->acc >> 56);
+        w->acc <<= 8;
+    }
+}
+
+// 패킹된 비트를 앞에서부터 차례로 읽는 구조체
+typedef struct {
+    const uint8_t *data; // 입력 시작
+    const uint8_t *p;    // 다음에 누산기로 읽어 올 바이트
+    const uint8_t *end;  // 입력 끝
+    uint64_t acc;        // 읽어 둔 비트 (left-aligned)
+    int nbits;           // acc에 있는 유효 비트 수
+} BitReader;
+
+// 누산기를 56비트 이상으로 채움 (입력 끝에서는 가능한 만큼만)
+static inline void refill_bits(BitReader *r)
+{
+    if (r->end - r->p >= 8) {
+        r->acc |= load_be64(r->p) >> r->nbits; // 걸친 바이트는 다음에 같은 값으로 다시 OR 됨
+        r->p += (63 - r->nbits) >> 3;
+        r->nbits |= 56;
+        return;
+    }
+    while (r->nbits <= 56 && r->p < r->end) {
+        r->acc |= (uint64_t)*r->p++ << (56 - r->nbits);
+        r->nbits += 8;
+    }
+}
+
+// data의 bit_offset 비트 위치로 이동
+static inline void seek_bits(BitReader *r, uint64_t bit_offset)
+{
+    r->p = r->data + (bit_offset >> 3);
+    if (r->p > r->end) r->p = r->end;
+    r->acc = 0;
+    r->nbits = 0;
+    int skip = (int)(bit_offset & 7);
+    if (skip) {
+        refill_bits(r);
+        r->acc <<= skip;
+        r->nbits = r->nbits > skip ? r->nbits - skip : 0;
+    }
+}
+
+static inline void init_bits(BitReader *r, const uint8_t *data, size_t size, uint64_t bit_offset)
+{
+    r->data = data;
+    r->end = data + size;
+    seek_bits(r, bit_offset);
+}
+
+// 현재 읽는 비트 위치
+static inline uint64_t tell_bits(const BitReader *r)
+{
+    return (uint64_t)(r->p - r->data) * 8 - r->nbits;
+}
+
+// 다음 n(<= 56) 비트를 left-aligned 로 읽기 (입력 끝을 넘는 부분은 0)
+static inline uint64_t get_bits56(BitReader *r, int n)
+{
+    if (r->nbits < n) refill_bits(r);
+    uint64_t v = r->acc & ~(~0ULL >> n);
+    r->acc <<= n;
+    r->nbits -= n;
+    if (r->nbits < 0) r->nbits = 0;
+    return v;
+}
+
+// 다음 n(<= 64) 비트를 left-aligned 로 읽기
+static inline uint64_t get_bits(BitReader *r, int n)
+{
+    if (n <= 0) return 0;
+    if (n <= 56) return get_bits56(r, n);
+    uint64_t hi = get_bits56(r, 32);
+    return hi | get_bits56(r, n - 32) >> 32;
+}
+
+// 입력의 bit_offset 부터 nbits 비트를 출력에 복사
+static inline void copy_bits(BitWriter *w, const uint8_t *data, uint64_t bit_offset, uint64_t nbits)
+{
+    if ((bit_offset & 7) == 0 && (w->nbits & 7) == 0) { // 양쪽 모두 바이트 경계: 누산기를 비우고 그대로 복사
+        const uint8_t *p = data + (bit_offset >> 3);
+        while (w->nbits && nbits >= 8) {
+            put_bits(w, (uint64_t)*p++ << 56, 8);
+            nbits -= 8;
+        }
+        if (w->nbits == 0) {
+            memcpy(w->buf + w->len, p, nbits >> 3);
+            w->len += nbits >> 3;
+            p += nbits >> 3;
+            nbits &= 7;
+        }
+        for (; nbits >= 8; nbits -= 8) put_bits(w, (uint64_t)*p++ << 56, 8);
+        if (nbits) put_bits(w, ((uint64_t)*p << 56) & ~(~0ULL >> nbits), (int)nbits);
+        return;
+    }
+    for (uint64_t b = 0; b < nbits; b += 64) {
+        int n = nbits - b < 64 ? (int)(nbits - b) : 64;
+        put_bits(w, load_bits(data, bit_offset + b, n), n);
+    }
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+// 잡음 채널: 패킹된 비트열의 비트를 뒤집어 전송 오류를 흉내 낸다 (crc_channel / crc_bench 공용)
+//
+// 비트마다 난수를 뽑는 대신 다음 오류까지의 간격을 기하분포로 뽑아 그 위치만 뒤집으므로
+// 비용이 비트 수가 아니라 오류 수에 비례한다. 난수는 xoshiro256** 를 쓴다.
+// channel_flip_linksim 은 과제에서 준 linksim 과 똑같은 결과를 낸다 (srand / rand 순서까지 같음).
+
+typedef struct {
+    uint64_t s[4];
+} ChannelRng;
+
+static inline uint64_t channel_rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// splitmix64 로 상태를 채움
+static inline void channel_seed(ChannelRng *rng, uint64_t seed)
+{
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        rng->s[i] = z ^ (z >> 31);
+    }
+}
+
+static inline uint64_t channel_next(ChannelRng *rng)
+{
+    uint64_t *s = rng->s;
+    uint64_t result = channel_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = channel_rotl(s[3], 45);
+    return result;
+}
+
+// (0, 1] 구간의 균등 난수
+static inline double channel_uniform(ChannelRng *rng)
+{
+    return ((channel_next(rng) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+// 확률 p 인 오류 사이의 간격 (다음 오류 앞에서 건너뛸 비트 수)
+static inline uint64_t channel_gap(ChannelRng *rng, double log_q)
+{
+    double g = floor(log(channel_uniform(rng)) / log_q);
+    return g < 1.8e19 ? (uint64_t)g : UINT64_MAX;
+}
+
+static inline void channel_flip_bit(uint8_t *data, uint64_t bit)
+{
+    data[bit >> 3] ^= (uint8_t)(0x80 >> (bit & 7));
+}
+
+// [first_bit, end_bit) 의 각 비트를 ber 확률로 독립적으로 뒤집고 뒤집은 비트 수 반환
+static inline uint64_t channel_flip_ber(uint8_t *data, uint64_t first_bit, uint64_t end_bit, double ber, ChannelRng *rng)
+{
+    uint64_t flips = 0;
+    if (ber <= 0 || first_bit >= end_bit) return 0;
+    if (ber >= 1) {
+        for (uint64_t b = first_bit; b < end_bit; b++) channel_flip_bit(data, b);
+        return end_bit - first_bit;
+    }
+    double log_q = log1p(-ber);
+    for (uint64_t b = first_bit;; b++) {
+        uint64_t gap = channel_gap(rng, log_q);
+        if (gap >= end_bit - b) break;
+        b += gap;
+        channel_flip_bit(data, b);
+        flips++;
+    }
+    return flips;
+}
+
+// 버스트 오류: 비트마다 rate 확률로 길이 length 의 버스트가 시작되고,
+// 버스트의 첫 비트와 마지막 비트는 항상, 그 사이 비트는 1/2 확률로 뒤집힘
+static inline uint64_t channel_flip_bursts(uint8_t *data, uint64_t first_bit, uint64_t end_bit, double rate, int length,
+                                           ChannelRng *rng)
+{
+    uint64_t flips = 0;
+    if (rate <= 0 || length < 1 || first_bit >= end_bit) return 0;
+    double log_q = rate < 1 ? log1p(-rate) : -INFINITY;
+    for (uint64_t b = first_bit;; b += length) {
+        uint64_t gap = rate < 1 ? channel_gap(rng, log_q) : 0;
+        if (gap >= end_bit - b) break;
+        b += gap;
+        uint64_t end = end_bit - b < (uint64_t)length ? end_bit : b + length;
+        uint64_t bits = 0;
+        for (uint64_t i = b; i < end; i++) {
+            if (((i - b) & 63) == 0) bits = channel_next(rng);
+            if (i == b || i == b + length - 1 || (bits >> ((i - b) & 63) & 1)) {
+                channel_flip_bit(data, i);
+                flips++;
+            }
+        }
+    }
+    return flips;
+}
+
+// linksim 과 같은 채널: 첫 바이트(패딩 크기)를 빼고 비트마다 rand() / RAND_MAX < ber 이면 뒤집음
+// log 가 있으면 뒤집은 비트마다 "error on bit N" 을 기록
+static inline uint64_t channel_flip_linksim(uint8_t *data, size_t len, double ber, int seed, FILE *log)
+{
+    uint64_t flips = 0;
+    srand(seed);
+    for (uint64_t b = 8; b < (uint64_t)len * 8; b++) {
+        if ((double)rand() / RAND_MAX < ber) {
+            channel_flip_bit(data, b);
+            flips++;
+            if (log) fprintf(log, "error on bit %d\n", (int)b);
+        }
+    }
+    return flips;
+}
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef CHUNK_POOL_H
+#define CHUNK_POOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+// 순서를 보존하는 청크 병렬 처리 (crc_encoder / crc_decoder 공용)
+//
+// 스트림을 프레임 경계에서 청크로 나누고, 작업 스레드들이 청크를 하나씩 가져가 처리한다.
+// 결과는 메인 스레드가 청크 번호 순서대로 emit 해서 출력 순서가 유지된다.
+// 동시에 처리 중인 청크 수는 스레드 수의 두 배로 제한되어 메모리 사용량이 일정하다.
+
+typedef struct {
+    uint8_t *data;       // 청크 출력
+    size_t len;          // 출력 바이트 수
+    size_t cap;
+    uint8_t *scratch;    // 작업용 버퍼 (입력 등)
+    size_t scratch_cap;
+    long long frames;    // 청크의 프레임 수
+    long long errors;    // 청크의 오류 프레임 수
+    long long corrected; // 청크에서 고친 프레임 수
+    uint64_t *marks;     // 청크 안에서 표시한 프레임 번호 (crc_decoder -x 의 오류 프레임)
+    size_t mark_count;
+    size_t mark_cap;
+} ChunkResult;
+
+typedef void (*chunk_fn)(void *ctx, uint64_t index, ChunkResult *result);
+
+#define CHUNK_FREE 0
+#define CHUNK_BUSY 1
+#define CHUNK_DONE 2
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    ChunkResult *results; // 슬롯별 결과 (청크 i는 슬롯 i % slot_count)
+    int *state;           // 슬롯 상태
+    uint64_t *owner;      // 슬롯이 담고 있는 청크 번호
+    int slot_count;
+    uint64_t next;        // 다음에 나눠줄 청크 번호
+    uint64_t chunk_count;
+    chunk_fn work;
+    void *ctx;
+} ChunkPool;
+
+// 버퍼가 need 바이트 이상이 되도록 늘림
+static inline void chunk_reserve(uint8_t **buf, size_t *cap, size_t need)
+{
+    if (*cap >= need) return;
+    free(*buf);
+    *buf = (uint8_t *)malloc(need);
+    if (!*buf) {
+        perror("memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    *cap = need;
+}
+
+static void *chunk_worker(void *arg)
+{
+    ChunkPool *pool = (ChunkPool *)arg;
+    pthread_mutex_lock(&pool->lock);
+    while (pool->next < pool->chunk_count) {
+        uint64_t index = pool->next;
+        int slot = (int)(index % pool->slot_count);
+        if (pool->state[slot] != CHUNK_FREE) { // 앞선 청크가 아직 출력되지 않음
+            pthread_cond_wait(&pool->cond, &pool->lock);
+            continue;
+        }
+        pool->next++;
+        pool->state[slot] = CHUNK_BUSY;
+        pool->owner[slot] = index;
+        pthread_mutex_unlock(&pool->lock);
+
+        ChunkResult *result = &pool->results[slot];
+        result->len = 0;
+        result->frames = 0;
+        result->errors = 0;
+        result->corrected = 0;
+        result->mark_count = 0;
+        pool->work(pool->ctx, index, result);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->state[slot] = CHUNK_DONE;
+        pthread_cond_broadcast(&pool->cond);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// chunk_count 개의 청크를 threads 개의 스레드로 처리하고 순서대로 emit 호출
+static void chunk_pool_run(int threads, uint64_t chunk_count, chunk_fn work, chunk_fn emit, void *ctx)
+{
+    if (threads <= 1) { // 단일 스레드: 슬롯 하나로 차례대로 처리
+        ChunkResult result;
+        memset(&result, 0, sizeof(result));
+        for (uint64_t i = 0; i < chunk_count; i++) {
+            result.len = 0;
+            result.frames = 0;
+            result.errors = 0;
+            result.corrected = 0;
+            result.mark_count = 0;
+            work(ctx, i, &result);
+            emit(ctx, i, &result);
+        }
+        free(result.data);
+        free(result.scratch);
+        free(result.marks);
+        return;
+    }
+
+    ChunkPool pool;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.cond, NULL);
+    pool.slot_count = threads * 2;
+    pool.results = (ChunkResult *)calloc(pool.slot_count, sizeof(ChunkResult));
+    pool.state = (int *)calloc(pool.slot_count, sizeof(int));
+    pool.owner = (uint64_t *)calloc(pool.slot_count, sizeof(uint64_t));
+    pthread_t *tids = (pthread_t *)calloc(threads, sizeof(pthread_t));
+    if (!pool.results || !pool.state || !pool.owner || !tids) {
+        perror("memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    pool.next = 0;
+    pool.chunk_count = chunk_count;
+    pool.work = work;
+    pool.ctx = ctx;
+
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&tids[t], NULL, chunk_worker, &pool) != 0) {
+            perror("thread creation error");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (uint64_t i = 0; i < chunk_count; i++) { // 청크 번호 순서대로 출력
+        int slot = (int)(i % pool.slot_count);
+        pthread_mutex_lock(&pool.lock);
+        while (pool.state[slot] != CHUNK_DONE || pool.owner[slot] != i) {
+            pthread_cond_wait(&pool.cond, &pool.lock);
+        }
+        pthread_mutex_unlock(&pool.lock);
+
+        emit(ctx, i, &pool.results[slot]);
+
+        pthread_mutex_lock(&pool.lock);
+        pool.state[slot] = CHUNK_FREE;
+        pthread_cond_broadcast(&pool.cond);
+        pthread_mutex_unlock(&pool.lock);
+    }
+
+    for (int t = 0; t < threads; t++) pthread_join(tids[t], NULL);
+    for (int s = 0; s < pool.slot_count; s++) {
+        free(pool.results[s].data);
+        free(pool.results[s].scratch);
+        free(pool.results[s].marks);
+    }
+    free(pool.results);
+    free(pool.state);
+    free(pool.owner);
+    free(tids);
+    pthread_cond_destroy(&pool.cond);
+    pthread_mutex_destroy(&pool.lock);
+}
+
+#endif
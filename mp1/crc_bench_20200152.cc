@@ -0,0 +1,346 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "crc_codec.h"
+#include "channel.h"
+
+// 코덱 처리량 측정 (crc_codec.h 로 crc_encoder / crc_decoder 의 프레임 루프를 메모리 위에서 직접 실행)
+//
+// 생성기 x 데이터워드 크기 x 입력 크기 조합마다 인코딩, 디코딩, 잡음 섞인 스트림 디코딩,
+// 왕복(인코딩 + 디코딩)의 MB/s 와 프레임당 ns 를 출력한다.
+// 각 조합은 먼저 작은 입력에서 문자열 나눗셈 기준 구현과 비트 단위로 비교하고,
+// 하나라도 어긋나면 0이 아닌 값으로 종료하므로 hot path 변경의 검사용으로 쓸 수 있다.
+
+#define BENCH_MIN_TIME 0.2   // 한 측정의 최소 시간 (초)
+#define CHECK_SIZE 4096      // 기준 구현과 비교할 입력 바이트 수
+
+static const char *default_generators[] = {
+    "10011",                                                             // CRC-4
+    "100000111",                                                         // CRC-8
+    "11000000000000101",                                                 // CRC-16
+    "100000100110000010001110110110111",                                 // CRC-32
+    "10100001011110000111000011110101110101001111010100011011010010011", // CRC-64 (ECMA-182)
+};
+static const int default_datawords[] = {4, 8, 16, 32, 64, 12, 1024, 8192}; // 1024 이상은 프레임마다 CRC_CLMUL_MIN 바이트 이상이라 접기 커널을 씀
+static const uint64_t default_sizes[] = {4ULL << 10, 256ULL << 10, 16ULL << 20, 1ULL << 30};
+
+static ChannelRng rng; // 입력과 잡음용 난수
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *xmalloc(size_t n)
+{
+    void *p = calloc(1, n ? n : 1);
+    if (!p) {
+        perror("memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// 기준 구현: '0'/'1' 문자열 나눗셈으로 s[0 .. n) 를 나누고 나머지 자리(s[n .. n + width))를 남김
+static void reference_divide(char *s, int n, const char *generator)
+{
+    int glen = (int)strlen(generator);
+    for (int i = 0; i < n; i++) {
+        if (s[i] != '1') continue;
+        for (int j = 0; j < glen; j++) s[i + j] = s[i + j] == generator[j] ? '0' : '1';
+    }
+}
+
+static int bit_at(const uint8_t *p, uint64_t i)
+{
+    return (p[i >> 3] >> (7 - (i & 7))) & 1;
+}
+
+// 기준 인코딩 (패킹된 결과), 반환값은 바이트 수
+static size_t reference_encode(const char *generator, int d, const uint8_t *in, uint64_t len, uint8_t *out)
+{
+    int width = (int)strlen(generator) - 1;
+    uint64_t frames = (len * 8 + d - 1) / d;
+    uint64_t code_bits = frames * (d + width);
+    int pad = bits_pad_size(code_bits);
+    uint64_t total = 8 + pad + code_bits;
+    memset(out, 0, (size_t)(total / 8));
+    out[0] = (uint8_t)pad;
+    char *s = (char *)xmalloc(d + width + 1);
+    uint64_t pos = 8 + pad;
+    for (uint64_t f = 0; f < frames; f++) {
+        for (int i = 0; i < d; i++) {
+            uint64_t b = f * d + i;
+            s[i] = b < len * 8 && bit_at(in, b) ? '1' : '0';
+        }
+        memset(s + d, '0', width);
+        reference_divide(s, d, generator);
+        for (int i = 0; i < d + width; i++, pos++) { // 데이터워드는 원래 값, 뒤에 나머지
+            int bit = i < d ? (f * d + i < len * 8 && bit_at(in, f * d + i)) : s[i] == '1';
+            if (bit) out[pos >> 3] |= 0x80 >> (pos & 7);
+        }
+    }
+    free(s);
+    return (size_t)(total / 8);
+}
+
+// 기준 디코딩: 오류 프레임 수
+static uint64_t reference_errors(const char *generator, int d, const uint8_t *in, size_t len)
+{
+    int width = (int)strlen(generator) - 1;
+    uint64_t total = (uint64_t)len * 8;
+    uint64_t pos = bits_data_start(in, len);
+    uint64_t errors = 0;
+    char *s = (char *)xmalloc(d + width + 1);
+    for (; pos < total; pos += d + width) {
+        uint64_t frame_len = total - pos < (uint64_t)(d + width) ? total - pos : (uint64_t)(d + width);
+        if (frame_len <= (uint64_t)width) continue;
+        for (uint64_t i = 0; i < frame_len; i++) s[i] = bit_at(in, pos + i) ? '1' : '0';
+        reference_divide(s, (int)(frame_len - width), generator);
+        for (uint64_t i = frame_len - width; i < frame_len; i++) {
+            if (s[i] == '1') {
+                errors++;
+                break;
+            }
+        }
+    }
+    free(s);
+    return errors;
+}
+
+// linksim 과 같은 잡음: 각 비트를 ber 확률로 뒤집음 (패딩 크기 바이트는 그대로)
+static void add_noise(uint8_t *p, size_t len, double ber)
+{
+    channel_flip_ber(p, 8, (uint64_t)len * 8, ber, &rng);
+}
+
+// 작은 입력으로 기준 구현과 비교. 어긋나면 0 반환
+static int check_codec(const CrcCodec *c, const char *generator, const uint8_t *fixture, uint64_t fixture_len, double ber)
+{
+    static CrcEncodeStream stream;
+    int d = c->dataword_size;
+    size_t len = (size_t)(fixture_len < CHECK_SIZE ? fixture_len : CHECK_SIZE);
+    size_t cap = crc_codec_encoded_size(c, len);
+    uint8_t *got = (uint8_t *)xmalloc(cap);
+    uint8_t *want = (uint8_t *)xmalloc(cap);
+    size_t out_cap = cap > len + CRC_MAX_DATAWORD / 8 ? cap : len + CRC_MAX_DATAWORD / 8;
+    uint8_t *out = (uint8_t *)xmalloc(out_cap);
+    size_t got_len, want_len, out_len, n;
+    CrcCounts counts;
+    int ok = 1;
+
+    crc_codec_encode(c, fixture, len, got, cap, &got_len);
+    want_len = reference_encode(generator, d, fixture, len, want);
+    if (got_len != want_len || memcmp(got, want, got_len) != 0) {
+        fprintf(stderr, "check failed: encode %s d=%d\n", generator, d);
+        ok = 0;
+    }
+
+    // 입력을 크기가 제각각인 조각으로 나눠 넣어도 결과가 같아야 함
+    size_t stream_len = 0;
+    crc_stream_begin(&stream, c, len, out, 2, &n);
+    int same = n <= want_len && memcmp(out, want, n) == 0;
+    stream_len += n;
+    for (size_t off = 0, piece = 1; off < len; off += piece, piece = piece * 3 + 1) {
+        if (piece > len - off) piece = len - off;
+        crc_stream_update(&stream, fixture + off, piece, out, crc_stream_update_size(&stream, piece), &n);
+        same = same && stream_len + n <= want_len && memcmp(out, want + stream_len, n) == 0;
+        stream_len += n;
+    }
+    crc_stream_finish(&stream, out, out_cap, &n);
+    same = same && stream_len + n == want_len && memcmp(out, want + stream_len, n) == 0;
+    if (!same) {
+        fprintf(stderr, "check failed: stream encode %s d=%d\n", generator, d);
+        ok = 0;
+    }
+
+    crc_codec_decode(c, got, got_len, out, out_cap, &out_len, &counts);
+    if (counts.errors != 0 || memcmp(out, fixture, len) != 0) {
+        fprintf(stderr, "check failed: round trip %s d=%d\n", generator, d);
+        ok = 0;
+    }
+
+    add_noise(want, want_len, ber > 0 ? ber : 1e-3); // 잡음이 섞인 스트림의 오류 수
+    crc_codec_verify(c, want, want_len, &counts);
+    if (counts.errors != reference_errors(generator, d, want, want_len)) {
+        fprintf(stderr, "check failed: noisy decode %s d=%d\n", generator, d);
+        ok = 0;
+    }
+
+    free(got);
+    free(want);
+    free(out);
+    return ok;
+}
+
+// 입력 크기 문자열 파싱 (K, M, G 접미사)
+static uint64_t parse_size(const char *s)
+{
+    char *end;
+    uint64_t v = strtoull(s, &end, 10);
+    if (*end == 'K' || *end == 'k') v <<= 10;
+    else if (*end == 'M' || *end == 'm') v <<= 20;
+    else if (*end == 'G' || *end == 'g') v <<= 30;
+    return v;
+}
+
+// 입력 파일 전체 읽기
+static uint8_t *read_fixture(const char *filename, uint64_t *len)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "input file open error.\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t cap = 1 << 16, n;
+    uint8_t *data = (uint8_t *)xmalloc(cap);
+    *len = 0;
+    while ((n = fread(data + *len, 1, cap - *len, file)) > 0) {
+        *len += n;
+        if (*len == cap) {
+            cap *= 2;
+            data = (uint8_t *)realloc(data, cap);
+            if (!data) {
+                perror("memory allocation error");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    fclose(file);
+    return data;
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t max_size = 16ULL << 20; // 측정할 최대 입력 크기
+    const char *generator = NULL;    // 지정하면 이 생성기만 측정
+    int dataword = 0;                // 지정하면 이 데이터워드 크기만 측정
+    double ber = 1e-4;               // 잡음 스트림의 비트 오류율
+    const char *fixture_file = NULL; // 지정하면 난수 대신 이 파일을 반복해 입력으로 씀
+    channel_seed(&rng, 1);
+    int opt;
+    while ((opt = getopt(argc, argv, "m:g:d:e:f:")) != -1)
+    {
+        switch (opt) {
+        case 'm': max_size = parse_size(optarg); break;
+        case 'g': generator = optarg; break;
+        case 'd': dataword = atoi(optarg); break;
+        case 'e': ber = atof(optarg); break;
+        case 'f': fixture_file = optarg; break;
+        default:
+            fprintf(stderr, "usage: ./crc_bench [-m max_size] [-g generator] [-d dataword_size] [-e ber] [-f fixture_file]\n");
+            exit(1);
+        }
+    }
+    if (dataword < 0 || dataword > CRC_MAX_DATAWORD || max_size == 0)
+    {
+        fprintf(stderr, "usage: ./crc_bench [-m max_size] [-g generator] [-d dataword_size] [-e ber] [-f fixture_file]\n");
+        exit(1);
+    }
+
+    const char **generators = generator ? &generator : default_generators;
+    int generator_count = generator ? 1 : (int)(sizeof(default_generators) / sizeof(default_generators[0]));
+    const int *datawords = dataword ? &dataword : default_datawords;
+    int dataword_count = dataword ? 1 : (int)(sizeof(default_datawords) / sizeof(default_datawords[0]));
+    uint64_t sizes[8];
+    int size_count = 0;
+    for (size_t i = 0; i < sizeof(default_sizes) / sizeof(default_sizes[0]) && default_sizes[i] < max_size; i++)
+        sizes[size_count++] = default_sizes[i];
+    sizes[size_count++] = max_size;
+
+    // 입력: 가장 큰 크기만큼 만들어 두고 앞부분을 잘라 씀
+    uint64_t fixture_len;
+    uint8_t *fixture = (uint8_t *)xmalloc((size_t)max_size);
+    if (fixture_file) {
+        uint64_t file_len;
+        uint8_t *file = read_fixture(fixture_file, &file_len);
+        if (file_len == 0) {
+            fprintf(stderr, "fixture file is empty.\n");
+            exit(1);
+        }
+        for (uint64_t i = 0; i < max_size; i++) fixture[i] = file[i % file_len];
+        free(file);
+    } else {
+        for (uint64_t i = 0; i < max_size; i += 8) {
+            uint64_t v = channel_next(&rng);
+            memcpy(fixture + i, &v, max_size - i < 8 ? (size_t)(max_size - i) : 8);
+        }
+    }
+    fixture_len = max_size;
+
+    size_t out_cap = 0;
+    for (int g = 0; g < generator_count; g++) {
+        for (int k = 0; k < dataword_count; k++) {
+            CrcCodec probe;
+            if (crc_codec_init(&probe, generators[g], datawords[k]) != 0) {
+                fprintf(stderr, "generator must be a binary string of 1 to %d bits.\n", CRC_MAX_WIDTH + 1);
+                exit(1);
+            }
+            size_t n = crc_codec_encoded_size(&probe, max_size);
+            if (n > out_cap) out_cap = n;
+            crc_codec_free(&probe);
+        }
+    }
+    uint8_t *encoded = (uint8_t *)xmalloc(out_cap);
+    uint8_t *noisy = (uint8_t *)xmalloc(out_cap);
+    size_t decoded_cap = (size_t)max_size + CRC_MAX_DATAWORD / 8 + 16;
+    uint8_t *decoded = (uint8_t *)xmalloc(decoded_cap);
+
+    printf("%-8s %6s %10s | %9s %9s | %9s %9s | %9s %9s | %9s | %s\n", "crc", "d", "size", "enc MB/s", "ns/frame",
+           "dec MB/s", "ns/frame", "noisy MB/s", "ns/frame", "rt MB/s", "check");
+    int failures = 0;
+    for (int g = 0; g < generator_count; g++) {
+        for (int k = 0; k < dataword_count; k++) {
+            int d = datawords[k];
+            CrcCodec codec;
+            crc_codec_init(&codec, generators[g], d);
+            int ok = check_codec(&codec, generators[g], fixture, fixture_len, ber);
+            failures += !ok;
+
+            for (int s = 0; s < size_count; s++) {
+                size_t len = (size_t)sizes[s];
+                uint64_t frames = ((uint64_t)len * 8 + d - 1) / d;
+                double t, enc_time, dec_time, noisy_time;
+                int reps;
+                size_t encoded_len = 0, decoded_len;
+                CrcCounts counts;
+                for (reps = 0, t = now(); reps == 0 || now() - t < BENCH_MIN_TIME; reps++)
+                    crc_codec_encode(&codec, fixture, len, encoded, out_cap, &encoded_len);
+                enc_time = (now() - t) / reps;
+
+                for (reps = 0, t = now(); reps == 0 || now() - t < BENCH_MIN_TIME; reps++)
+                    crc_codec_decode(&codec, encoded, encoded_len, decoded, decoded_cap, &decoded_len, &counts);
+                dec_time = (now() - t) / reps;
+                if (counts.errors != 0 || memcmp(decoded, fixture, len) != 0) {
+                    fprintf(stderr, "round trip mismatch: %s d=%d size=%llu\n", generators[g], d, (unsigned long long)len);
+                    ok = 0;
+                    failures++;
+                }
+
+                memcpy(noisy, encoded, encoded_len);
+                add_noise(noisy, encoded_len, ber);
+                for (reps = 0, t = now(); reps == 0 || now() - t < BENCH_MIN_TIME; reps++)
+                    crc_codec_decode(&codec, noisy, encoded_len, decoded, decoded_cap, &decoded_len, &counts);
+                noisy_time = (now() - t) / reps;
+
+                double mb = len / 1e6;
+                printf("CRC-%-4d %6d %10llu | %9.1f %9.2f | %9.1f %9.2f | %9.1f %9.2f | %9.1f | %s\n", codec.engine.width, d,
+                       (unsigned long long)len, mb / enc_time, enc_time * 1e9 / frames, mb / dec_time, dec_time * 1e9 / frames,
+                       mb / noisy_time, noisy_time * 1e9 / frames, mb / (enc_time + dec_time), ok ? "ok" : "FAIL");
+                fflush(stdout);
+            }
+            crc_codec_free(&codec);
+        }
+    }
+
+    free(fixture);
+    free(encoded);
+    free(noisy);
+    free(decoded);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "crc_codec.h"
+#include "channel.h"
+
+// 잡음 채널 시뮬레이터
+//
+// 1) linksim 호환: ./crc_channel input_file output_file error_ratio seed
+//    linksim 과 같은 파일과 같은 "error on bit N" 출력을 만든다.
+// 2) 시뮬레이션: 인코딩 -> 채널 -> 디코딩을 메모리 안에서 이어 실행하고
+//    생성기마다 처리량과 오류 검출률(실제로 손상된 프레임 중 검출한 비율)을 출력한다.
+
+static const char *default_generators[] = {
+    "10011",                                                             // CRC-4
+    "100000111",                                                         // CRC-8
+    "11000000000000101",                                                 // CRC-16
+    "100000100110000010001110110110111",                                 // CRC-32
+    "10100001011110000111000011110101110101001111010100011011010010011", // CRC-64 (ECMA-182)
+};
+
+#define MAX_GENERATORS 64
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *xmalloc(size_t n)
+{
+    void *p = malloc(n ? n : 1);
+    if (!p) {
+        perror("memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// linksim 호환 모드
+static int run_linksim(char *argv[])
+{
+    double ber = atof(argv[3]);
+    if (ber < 0 || ber > 1) {
+        fprintf(stderr, "error ratio must be between 0 and 1\n");
+        exit(1);
+    }
+    FILE *input_file = fopen(argv[1], "rb");
+    if (!input_file) {
+        fprintf(stderr, "input file open error.\n");
+        exit(1);
+    }
+    FILE *output_file = fopen(argv[2], "wb");
+    if (!output_file) {
+        fprintf(stderr, "output file open error.\n");
+        exit(1);
+    }
+
+    size_t cap = 1 << 16, len = 0, n;
+    uint8_t *data = (uint8_t *)xmalloc(cap);
+    while ((n = fread(data + len, 1, cap - len, input_file)) > 0) {
+        len += n;
+        if (len == cap) {
+            cap *= 2;
+            data = (uint8_t *)realloc(data, cap);
+            if (!data) {
+                perror("memory allocation error");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    channel_flip_linksim(data, len, ber, atoi(argv[4]), stdout);
+    if (fwrite(data, 1, len, output_file) != len) {
+        perror("output file write error");
+        exit(EXIT_FAILURE);
+    }
+    free(data);
+    fclose(input_file);
+    fclose(output_file);
+    return 0;
+}
+
+// 깨끗한 스트림과 잡음 스트림을 비교해 비트가 하나라도 바뀐 프레임 수를 셈
+static uint64_t count_corrupted(const uint8_t *clean, const uint8_t *noisy, size_t len, uint64_t start_bit, uint64_t frame_size)
+{
+    uint64_t corrupted = 0;
+    uint64_t last = UINT64_MAX; // 마지막으로 센 프레임
+    for (size_t i = 0; i < len; i += 8) {
+        uint64_t a = 0, b = 0;
+        size_t n = len - i < 8 ? len - i : 8;
+        memcpy(&a, clean + i, n);
+        memcpy(&b, noisy + i, n);
+        uint64_t diff = __builtin_bswap64(a ^ b); // 비트 순서를 스트림 순서로
+        while (diff) {
+            int lead = __builtin_clzll(diff);
+            uint64_t bit = (uint64_t)i * 8 + lead;
+            diff ^= 1ULL << (63 - lead); // 가장 앞의 비트 지움
+            if (bit < start_bit) continue;
+            uint64_t frame = (bit - start_bit) / frame_size;
+            if (frame != last) {
+                corrupted++;
+                last = frame;
+            }
+        }
+    }
+    return corrupted;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: ./crc_channel input_file output_file error_ratio(0-1) seed_num\n");
+    fprintf(stderr, "       ./crc_channel [-e ber] [-b rate:length] [-g generator]... [-d dataword_size] [-s size] [-n rounds] [-r seed]\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 5 && argv[1][0] != '-') return run_linksim(argv);
+
+    const char *generators[MAX_GENERATORS];
+    int generator_count = 0;
+    double ber = 1e-4;         // 비트 오류율
+    double burst_rate = 0;     // 비트마다 버스트가 시작될 확률 (0 이면 버스트 없음)
+    int burst_length = 0;
+    int dataword_size = 8;
+    uint64_t size = 16 << 20;  // 한 번에 보내는 입력 바이트 수
+    int rounds = 1;
+    uint64_t seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "e:b:g:d:s:n:r:")) != -1)
+    {
+        switch (opt) {
+        case 'e': ber = atof(optarg); break;
+        case 'b':
+            if (sscanf(optarg, "%lf:%d", &burst_rate, &burst_length) != 2 || burst_length < 1) usage();
+            break;
+        case 'g':
+            if (generator_count == MAX_GENERATORS) usage();
+            generators[generator_count++] = optarg;
+            break;
+        case 'd': dataword_size = atoi(optarg); break;
+        case 's': size = strtoull(optarg, NULL, 10); break;
+        case 'n': rounds = atoi(optarg); break;
+        case 'r': seed = strtoull(optarg, NULL, 10); break;
+        default: usage();
+        }
+    }
+    if (optind != argc || ber < 0 || ber > 1 || burst_rate < 0 || burst_rate > 1 || rounds < 1 || size == 0)
+        usage();
+    if (generator_count == 0) {
+        generator_count = (int)(sizeof(default_generators) / sizeof(default_generators[0]));
+        memcpy(generators, default_generators, sizeof(default_generators));
+    }
+
+    ChannelRng rng;
+    channel_seed(&rng, seed);
+    uint8_t *input = (uint8_t *)xmalloc((size_t)size);
+    for (uint64_t i = 0; i < size; i += 8) {
+        uint64_t v = channel_next(&rng);
+        memcpy(input + i, &v, size - i < 8 ? (size_t)(size - i) : 8);
+    }
+
+    if (burst_rate > 0)
+        printf("channel: ber %g, bursts %g x %d bits, %d round(s) of %llu bytes\n", ber, burst_rate, burst_length, rounds,
+               (unsigned long long)size);
+    else
+        printf("channel: ber %g, %d round(s) of %llu bytes\n", ber, rounds, (unsigned long long)size);
+    printf("%-8s %6s %12s %12s %12s %12s %12s %10s | %9s %9s\n", "crc", "d", "frames", "flipped", "corrupted", "detected",
+           "undetected", "detect %", "MB/s", "ns/frame");
+
+    for (int g = 0; g < generator_count; g++) {
+        CrcCodec codec;
+        if (crc_codec_init(&codec, generators[g], dataword_size) != 0) {
+            fprintf(stderr, "generator must be a binary string of 1 to %d bits and dataword size between 1 and %d.\n",
+                    CRC_MAX_WIDTH + 1, CRC_MAX_DATAWORD);
+            exit(1);
+        }
+        size_t cap = crc_codec_encoded_size(&codec, size);
+        uint8_t *clean = (uint8_t *)xmalloc(cap);
+        uint8_t *noisy = (uint8_t *)xmalloc(cap);
+        uint64_t frames = 0, flipped = 0, corrupted = 0, detected = 0;
+        double elapsed = 0;
+
+        for (int r = 0; r < rounds; r++) {
+            size_t len;
+            CrcCounts counts;
+            double t = now();
+            if (crc_codec_encode(&codec, input, (size_t)size, clean, cap, &len) != 0) {
+                fprintf(stderr, "encode failed: output buffer too small.\n");
+                exit(1);
+            }
+            memcpy(noisy, clean, len);
+            uint64_t start = bits_data_start(noisy, len); // 패딩은 건드리지 않음
+            flipped += channel_flip_ber(noisy, start, (uint64_t)len * 8, ber, &rng);
+            flipped += channel_flip_bursts(noisy, start, (uint64_t)len * 8, burst_rate, burst_length, &rng);
+            crc_codec_verify(&codec, noisy, len, &counts);
+            elapsed += now() - t;
+
+            frames += counts.frames;
+            detected += counts.errors;
+            corrupted += count_corrupted(clean, noisy, len, start, dataword_size + codec.engine.width);
+        }
+
+        printf("CRC-%-4d %6d %12llu %12llu %12llu %12llu %12llu %9.4f%% | %9.1f %9.2f\n", codec.engine.width, dataword_size,
+               (unsigned long long)frames, (unsigned long long)flipped, (unsigned long long)corrupted,
+               (unsigned long long)detected, (unsigned long long)(corrupted - detected),
+               corrupted ? 100.0 * detected / corrupted : 100.0, size * rounds / 1e6 / elapsed, elapsed * 1e9 / frames);
+        fflush(stdout);
+        free(clean);
+        free(noisy);
+        crc_codec_free(&codec);
+    }
+    free(input);
+    return 0;
+}
@@ -0,0 +1,265 @@
+#ifndef CRC_CODEC_H
+#define CRC_CODEC_H
+
+#include "crc_frame.h"
+
+// 메모리 버퍼용 CRC 코덱 (파일 경로 없이 프로그램 안에서 직접 호출)
+//
+// 생성기와 데이터워드 크기마다 한 번 crc_codec_init 으로 만들고, 출력 형식은
+// crc_encoder / crc_decoder 와 같다. 버퍼는 모두 호출자가 주고 코덱은 메모리를 할당하지 않는다.
+//   crc_codec_encode               입력 전체를 한 번에 인코딩
+//   crc_stream_begin/update/finish 입력을 나눠 받아 인코딩 (전체 길이는 패딩 크기 때문에 미리 알아야 함)
+//   crc_codec_decode               데이터워드를 꺼내고 프레임 수와 오류 수를 셈
+//   crc_codec_verify               데이터워드 없이 프레임 수와 오류 수만 셈
+// 출력 버퍼가 작거나 길이가 맞지 않으면 -1 을 반환한다.
+
+#define CRC_STREAM_SCRATCH (64 * 1024) // 바이트 경계에 맞지 않는 입력을 옮겨 담는 버퍼 크기
+
+typedef struct {
+    CrcEngine engine;
+    int dataword_size;
+    crc_encode_fn encode; // 데이터워드 크기에 맞게 선택된 프레임 루프
+    crc_decode_fn decode;
+} CrcCodec;
+
+typedef struct {
+    uint64_t frames; // 프레임 수
+    uint64_t errors; // 오류 프레임 수
+} CrcCounts;
+
+// 나눠 받는 인코딩 상태
+typedef struct {
+    const CrcCodec *codec;
+    uint64_t remaining;                          // 아직 받지 않은 입력 바이트 수
+    uint64_t acc;                                // 바이트를 채우지 못한 출력 비트 (left-aligned)
+    int nbits;
+    int carry_bits;                              // 데이터워드를 채우지 못한 입력 비트 수
+    uint8_t carry[CRC_MAX_DATAWORD / 8 + 8];     // 그 비트 (0비트부터)
+    uint8_t scratch[CRC_STREAM_SCRATCH + 8];
+} CrcEncodeStream;
+
+static inline int crc_codec_init(CrcCodec *c, const char *generator, int dataword_size)
+{
+    if (dataword_size < 1 || dataword_size > CRC_MAX_DATAWORD) return -1;
+    if (crc_engine_init(&c->engine, generator) != 0) return -1;
+    c->dataword_size = dataword_size;
+    crc_select_frames(&c->engine, dataword_size, &c->encode, &c->decode);
+    return 0;
+}
+
+static inline void crc_codec_free(CrcCodec *c)
+{
+    crc_engine_free(&c->engine);
+}
+
+// len 바이트 입력을 인코딩한 결과의 바이트 수
+static inline size_t crc_codec_encoded_size(const CrcCodec *c, uint64_t len)
+{
+    int d = c->dataword_size;
+    uint64_t code_bits = (len * 8 + d - 1) / d * (d + c->engine.width);
+    return (size_t)((8 + bits_pad_size(code_bits) + code_bits) / 8);
+}
+
+// len 바이트 인코딩 결과를 디코딩한 데이터워드의 바이트 수
+static inline size_t crc_codec_decoded_size(const CrcCodec *c, const uint8_t *in, size_t len)
+{
+    uint64_t total = (uint64_t)len * 8;
+    uint64_t start = bits_data_start(in, len);
+    uint64_t frame_size = c->dataword_size + c->engine.width;
+    if (total <= start) return 0;
+    uint64_t whole = (total - start) / frame_size;
+    uint64_t tail = (total - start) % frame_size;
+    if (tail > (uint64_t)c->dataword_size) tail = c->dataword_size;
+    return (size_t)((whole * c->dataword_size + tail + 7) / 8);
+}
+
+// 입력 in 의 bit_offset 부터 frames 개의 데이터워드를 인코딩
+// 프레임 루프는 바이트 경계에서 시작하는 입력을 받으므로 어긋난 입력은 scratch 로 옮겨 처리
+static inline void crc_codec_encode_bits(const CrcCodec *c, const uint8_t *in, uint64_t bit_offset, uint64_t frames,
+                                         uint8_t *scratch, BitWriter *w)
+{
+    int d = c->dataword_size;
+    if ((bit_offset & 7) == 0) {
+        c->encode(&c->engine, d, in + (bit_offset >> 3), frames, w);
+        return;
+    }
+    uint64_t step = (uint64_t)CRC_STREAM_SCRATCH * 8 / d;
+    for (uint64_t f = 0; f < frames; f += step) {
+        uint64_t n = frames - f < step ? frames - f : step;
+        BitWriter sw = {scratch, 0, 0, 0};
+        copy_bits(&sw, in, bit_offset + f * d, n * d);
+        finish_bits(&sw);
+        c->encode(&c->engine, d, scratch, n, w);
+    }
+}
+
+// 입력 전체를 한 번에 인코딩
+static inline int crc_codec_encode(const CrcCodec *c, const uint8_t *in, size_t len, uint8_t *out, size_t out_cap, size_t *out_len)
+{
+    int d = c->dataword_size;
+    if (out_cap < crc_codec_encoded_size(c, len)) return -1;
+    uint64_t bits = (uint64_t)len * 8;
+    uint64_t whole = bits / d;
+    uint64_t frames = (bits + d - 1) / d;
+    int pad = bits_pad_size(frames * (d + c->engine.width));
+    size_t header_len = bits_pad_prefix(out, pad);
+    BitWriter w = {out + header_len, 0, 0, pad % 8};
+    c->encode(&c->engine, d, in, whole, &w);
+    if (whole < frames) { // 마지막 데이터워드는 0으로 채움
+        uint8_t last[CRC_MAX_DATAWORD / 8 + 8];
+        memset(last, 0, sizeof(last));
+        BitWriter lw = {last, 0, 0, 0};
+        copy_bits(&lw, in, whole * d, bits - whole * d);
+        finish_bits(&lw);
+        c->encode(&c->engine, d, last, 1, &w);
+    }
+    finish_bits(&w);
+    *out_len = header_len + w.len;
+    return 0;
+}
+
+// 입력 total_len 바이트를 나눠 받는 인코딩 시작, 출력 앞부분(패딩 크기 바이트)을 out 에 씀
+static inline int crc_stream_begin(CrcEncodeStream *s, const CrcCodec *c, uint64_t total_len, uint8_t *out, size_t out_cap, size_t *out_len)
+{
+    int d = c->dataword_size;
+    uint64_t frames = (total_len * 8 + d - 1) / d;
+    int pad = bits_pad_size(frames * (d + c->engine.width));
+    if (out_cap < 2) return -1;
+    uint8_t header[2];
+    size_t header_len = bits_pad_prefix(header, pad);
+    memcpy(out, header, header_len);
+    *out_len = header_len;
+    s->codec = c;
+    s->remaining = total_len;
+    s->acc = 0;
+    s->nbits = pad % 8;
+    s->carry_bits = 0;
+    return 0;
+}
+
+// len 바이트 입력에 대해 out 에 써야 하는 최대 바이트 수
+static inline size_t crc_stream_update_size(const CrcEncodeStream *s, size_t len)
+{
+    const CrcCodec *c = s->codec;
+    uint64_t frames = (s->carry_bits + (uint64_t)len * 8) / c->dataword_size;
+    return (size_t)((s->nbits + frames * (c->dataword_size + c->engine.width)) / 8);
+}
+
+// 입력 일부를 인코딩해서 다 찬 바이트를 out 에 씀
+static inline int crc_stream_update(CrcEncodeStream *s, const uint8_t *in, size_t len, uint8_t *out, size_t out_cap, size_t *out_len)
+{
+    const CrcCodec *c = s->codec;
+    int d = c->dataword_size;
+    if (len > s->remaining || out_cap < crc_stream_update_size(s, len)) return -1;
+    s->remaining -= len;
+
+    BitWriter w = {out, 0, s->acc, s->nbits};
+    uint64_t bits = (uint64_t)len * 8;
+    uint64_t off = 0;
+    if (s->carry_bits > 0) { // 앞에서 남은 비트로 데이터워드 하나를 먼저 채움
+        uint64_t take = (uint64_t)(d - s->carry_bits) < bits ? (uint64_t)(d - s->carry_bits) : bits;
+        BitWriter cw = {s->carry, (size_t)(s->carry_bits / 8), 0, s->carry_bits % 8};
+        cw.acc = cw.nbits ? (uint64_t)s->carry[cw.len] << 56 : 0;
+        copy_bits(&cw, in, 0, take);
+        finish_bits(&cw);
+        s->carry_bits += (int)take;
+        off = take;
+        if (s->carry_bits == d) {
+            c->encode(&c->engine, d, s->carry, 1, &w);
+            s->carry_bits = 0;
+        }
+    }
+    uint64_t frames = (bits - off) / d;
+    crc_codec_encode_bits(c, in, off, frames, s->scratch, &w);
+    off += frames * d;
+    if (off < bits) { // 남은 비트는 다음 입력과 합침
+        BitWriter cw = {s->carry, 0, 0, 0};
+        copy_bits(&cw, in, off, bits - off);
+        finish_bits(&cw);
+        s->carry_bits = (int)(bits - off);
+    }
+    flush_bytes(&w);
+    s->acc = w.acc;
+    s->nbits = w.nbits;
+    *out_len = w.len;
+    return 0;
+}
+
+// 남은 입력(마지막 데이터워드는 0으로 채움)과 출력 비트를 out 에 씀
+static inline int crc_stream_finish(CrcEncodeStream *s, uint8_t *out, size_t out_cap, size_t *out_len)
+{
+    const CrcCodec *c = s->codec;
+    int d = c->dataword_size;
+    if (s->remaining != 0 || out_cap < (size_t)((s->nbits + d + c->engine.width + 7) / 8)) return -1;
+    BitWriter w = {out, 0, s->acc, s->nbits};
+    if (s->carry_bits > 0) {
+        int used = (s->carry_bits + 7) / 8;
+        memset(s->carry + used, 0, sizeof(s->carry) - used);
+        c->encode(&c->engine, d, s->carry, 1, &w);
+        s->carry_bits = 0;
+    }
+    finish_bits(&w);
+    s->acc = 0;
+    s->nbits = 0;
+    *out_len = w.len;
+    return 0;
+}
+
+// 인코딩된 버퍼를 디코딩: 데이터워드를 out 에 쓰고 프레임 수와 오류 수를 counts 에 기록
+static inline int crc_codec_decode(const CrcCodec *c, const uint8_t *in, size_t len, uint8_t *out, size_t out_cap, size_t *out_len,
+                                   CrcCounts *counts)
+{
+    const CrcEngine *e = &c->engine;
+    int d = c->dataword_size;
+    if (out_cap < crc_codec_decoded_size(c, in, len)) return -1;
+    uint64_t total = (uint64_t)len * 8;
+    uint64_t start = bits_data_start(in, len);
+    uint64_t frame_size = d + e->width;
+    uint64_t whole = total > start ? (total - start) / frame_size : 0;
+    BitReader r;
+    BitWriter w = {out, 0, 0, 0};
+    uint64_t corrected = 0;
+    init_bits(&r, in, len, start);
+    counts->errors = c->decode(e, d, &r, whole, &w, NULL, &corrected, NULL);
+    counts->frames = whole;
+    uint64_t pos = start + whole * frame_size;
+    if (pos < total) { // 입력 끝의 잘린 프레임
+        uint64_t frame_len = total - pos;
+        if (frame_len > (uint64_t)e->width && crc_engine_check(e, in, pos, frame_len - e->width)) counts->errors++;
+        copy_bits(&w, in, pos, frame_len < (uint64_t)d ? frame_len : d);
+        counts->frames++;
+    }
+    finish_bits(&w);
+    *out_len = w.len;
+    return 0;
+}
+
+// 인코딩된 버퍼의 프레임 수와 오류 수만 셈 (데이터워드는 작은 버퍼에 받아 버림)
+static inline void crc_codec_verify(const CrcCodec *c, const uint8_t *in, size_t len, CrcCounts *counts)
+{
+    const CrcEngine *e = &c->engine;
+    int d = c->dataword_size;
+    uint64_t total = (uint64_t)len * 8;
+    uint64_t start = bits_data_start(in, len);
+    uint64_t frame_size = d + e->width;
+    uint64_t whole = total > start ? (total - start) / frame_size : 0;
+    uint8_t sink[CRC_MAX_DATAWORD / 8 * 2 + 16];
+    uint64_t step = (uint64_t)(sizeof(sink) - 16) * 8 / d;
+    uint64_t corrected = 0;
+    BitReader r;
+    init_bits(&r, in, len, start);
+    counts->errors = 0;
+    for (uint64_t f = 0; f < whole; f += step) {
+        BitWriter w = {sink, 0, 0, 0};
+        counts->errors += c->decode(e, d, &r, whole - f < step ? whole - f : step, &w, NULL, &corrected, NULL);
+    }
+    counts->frames = whole;
+    uint64_t pos = start + whole * frame_size;
+    if (pos < total) {
+        uint64_t frame_len = total - pos;
+        if (frame_len > (uint64_t)e->width && crc_engine_check(e, in, pos, frame_len - e->width)) counts->errors++;
+        counts->frames++;
+    }
+}
+
+#endif
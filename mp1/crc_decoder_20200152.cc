@@ -2,67 +2,190 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <dirent.h>
 
-#define MAX 2 * 20 * 20 * 512 * 512
+#include "crc_frame.h"
+#include "crc_table_cache.h"
+#include "chunk_pool.h"
 
-// 프레임과 생성기 다항식을 사용하여 CRC 나머지 계산
-int calculate_crc_remainder(char *frame, char *generator) {
-    int frame_len = strlen(frame);  // 프레임의 길이 계산
-    int generator_len = strlen(generator);  // 생성기 다항식의 길이 계산
-    for (int i = 0; i <= frame_len - generator_len; i++) {  // 프레임 전체를 순회
-        if (frame[i] == '1') {  // 프레임의 i번째 비트가 1인 경우
-            for (int j = 0; j < generator_len; j++) {  // 생성기 다항식의 길이만큼 XOR 연산 수행
-                frame[i + j] = (frame[i + j] == generator[j] ? '0' : '1');
-            }
+#define CHUNK_SIZE (64 * 1024) // 매핑할 수 없는 입력을 읽을 때 쓰는 버퍼 크기
+#define CHUNK_BITS (8 << 20)   // 청크 하나의 대략적인 입력 비트 수
+
+// 청크 작업에 필요한 공용 정보
+typedef struct {
+    const CrcEngine *engine;
+    crc_decode_fn decode;      // 데이터워드 크기에 맞게 선택된 프레임 루프
+    const CrcSyndromes *fix;   // 단일 비트 오류 정정 표 (-c 가 아니면 NULL)
+    const uint8_t *input;
+    uint64_t total_bits;       // 입력 전체 비트 수
+    uint64_t start_bit;        // 첫 프레임 위치 (패딩 크기 바이트 + 패딩 다음)
+    int dataword_size;
+    uint64_t frame_size;
+    uint64_t frames_per_chunk; // 8의 배수라서 청크 출력은 항상 바이트 단위로 끝남
+    uint64_t frame_count;
+    FILE *output_file;         // NULL 이면 데이터워드를 쓰지 않음 (검사만)
+    long long count;           // 프레임 카운트
+    long long error;           // 에러 카운트
+    long long corrected;       // 정정한 프레임 카운트
+    FILE *index_file;          // 오류 프레임 색인 (-x 가 아니면 NULL)
+    uint64_t run_start;        // 아직 쓰지 않은 오류 프레임 구간
+    uint64_t run_len;
+    uint64_t run_end;          // 마지막으로 쓴 구간의 끝
+} DecodeJob;
+
+// 청크 하나의 프레임을 검사하고 데이터워드를 모음
+void decode_chunk(void *arg, uint64_t index, ChunkResult *result) {
+    DecodeJob *job = (DecodeJob *)arg;
+    const CrcEngine *engine = job->engine;
+    uint64_t first = index * job->frames_per_chunk;
+    uint64_t frames = job->frame_count - first < job->frames_per_chunk ? job->frame_count - first : job->frames_per_chunk;
+
+    chunk_reserve(&result->data, &result->cap, (size_t)(frames * job->dataword_size / 8) + 16);
+    BitWriter w = {result->data, 0, 0, 0};
+    uint64_t pos = job->start_bit + first * job->frame_size;
+    uint64_t whole = (job->total_bits - pos) / job->frame_size; // 온전한 프레임 수
+    if (whole > frames) whole = frames;
+    BitReader r;
+    init_bits(&r, job->input, job->total_bits / 8, pos);
+    uint64_t corrected = 0;
+    CrcFrameList bad = {result->marks, 0, result->mark_cap}; // 청크 안의 오류 프레임 번호
+    CrcFrameList *record = job->index_file ? &bad : NULL;
+    result->errors = (long long)job->decode(engine, job->dataword_size, &r, whole, &w, job->fix, &corrected, record); // 패킹된 비트 위에서 바로 프레임 검사
+    if (whole < frames) // 입력 끝의 잘린 프레임
+    {
+        pos += whole * job->frame_size;
+        uint64_t frame_len = job->total_bits - pos;
+        int failed = 0;
+        if (job->fix && frame_len > (uint64_t)engine->width) // 검사와 정정
+        {
+            int64_t bit = crc_correct_frame(engine, job->fix, job->input, pos, frame_len - engine->width, &w);
+            result->errors += bit != -1;
+            corrected += bit >= 0;
+            failed = bit == -2;
+        }
+        else
+        {
+            if (frame_len > (uint64_t)engine->width && crc_engine_check(engine, job->input, pos, frame_len - engine->width)) // CRC 검사
+                failed = 1;
+            result->errors += failed;
+            copy_bits(&w, job->input, pos, frame_len < (uint64_t)job->dataword_size ? frame_len : job->dataword_size); // 디코딩된 데이터 추가
         }
+        if (failed && record) crc_frame_list_add(record, whole);
     }
-    // 나머지 확인
-    for (int i = frame_len - generator_len + 1; i < frame_len; i++) {
-        if (frame[i] == '1') return 1; // 나머지가 1이면 에러 발견
+    result->corrected = (long long)corrected;
+    result->marks = bad.items;
+    result->mark_count = bad.count;
+    result->mark_cap = bad.cap;
+    finish_bits(&w);
+    result->len = w.len;
+    result->frames = (long long)frames;
+}
+
+// 오류 프레임 색인 (-x): 재전송할 프레임만 골라낼 수 있도록 오류 프레임 번호를 구간으로 묶어 기록
+//
+// 모든 수는 LEB128 varint (7비트씩, 하위부터, 이어지면 최상위 비트 1)
+// "CRCIDX1" 과 0 바이트 | 총 프레임 수 | 데이터워드 크기 | 생성기 차수
+// 이후 구간마다 (앞 구간 끝부터 건너뛴 정상 프레임 수, 연속한 오류 프레임 수), 파일 끝까지
+// -c 이면 고친 프레임은 정상으로 보고 고치지 못한 프레임만 기록한다.
+void put_varint(FILE *file, uint64_t v) {
+    uint8_t buf[10];
+    int n = 0;
+    do {
+        buf[n++] = (uint8_t)((v & 0x7f) | (v >= 0x80 ? 0x80 : 0));
+        v >>= 7;
+    } while (v);
+    if (fwrite(buf, 1, n, file) != (size_t)n) {
+        perror("index file write error");
+        exit(EXIT_FAILURE);
     }
-    return 0; // 나머지가 0이면 에러 없음
 }
 
-// 10진수를 8비트 이진 문자열로 변환
-char *convert_decimal_to_binary_string(int decimal)
-{
-    char *binary = (char *)malloc(sizeof(char) * 9); // 8비트 + NULL 문자('\0')를 위한 메모리 할당
-    if (!binary) {
-        perror("memory allocation error");  // 메모리 할당 실패시 에러 메시지 출력
-        exit(EXIT_FAILURE);  // 프로그램 비정상 종료
+void write_index_header(DecodeJob *job) {
+    if (fwrite("CRCIDX1", 1, 8, job->index_file) != 8) {
+        perror("index file write error");
+        exit(EXIT_FAILURE);
     }
-    int i;
-    for (i = 0; i < 8; i++)
-    {
-        *(binary + i) = ((decimal >> (7 - i)) & 1) + '0';  // 비트 연산을 통한 이진수 변환
+    put_varint(job->index_file, job->frame_count);
+    put_varint(job->index_file, (uint64_t)job->dataword_size);
+    put_varint(job->index_file, (uint64_t)job->engine->width);
+}
+
+// 모아 둔 오류 구간을 씀
+void flush_index_run(DecodeJob *job) {
+    if (job->run_len == 0) return;
+    put_varint(job->index_file, job->run_start - job->run_end);
+    put_varint(job->index_file, job->run_len);
+    job->run_end = job->run_start + job->run_len;
+    job->run_len = 0;
+}
+
+// 오류 프레임 하나 추가 (번호 순서대로 호출), 앞 구간에 바로 이어지면 구간을 늘림
+void add_index_frame(DecodeJob *job, uint64_t frame) {
+    if (job->run_len && frame == job->run_start + job->run_len) {
+        job->run_len++;
+        return;
     }
-    *(binary + i) = '\0'; // 문자열 끝에 NULL 문자 삽입
-    return binary;  // 변환된 이진 문자열 반환
+    flush_index_run(job);
+    job->run_start = frame;
+    job->run_len = 1;
 }
 
-// 이진 문자열을 unsigned char 값으로 변환
-unsigned char convert_binary_string_to_char(char *binary)
-{
-    unsigned char result = 0;
-    for (int i = 7; i >= 0; i--) {
-        result = (result << 1) + (binary[i] == '1');  // 이진 문자열을 unsigned char로 변환
+// 청크 결과를 순서대로 파일에 쓰고 카운트를 합산
+void write_chunk(void *arg, uint64_t index, ChunkResult *result) {
+    DecodeJob *job = (DecodeJob *)arg;
+    if (job->output_file && result->len && fwrite(result->data, 1, result->len, job->output_file) != result->len) {
+        perror("output file write error");
+        exit(EXIT_FAILURE);
     }
-    return result;
+    if (job->index_file) { // 청크 안 번호를 전체 번호로 바꿔 구간에 합침 (구간은 청크 경계를 넘어 이어질 수 있음)
+        uint64_t first = index * job->frames_per_chunk;
+        for (size_t i = 0; i < result->mark_count; i++) add_index_frame(job, first + result->marks[i]);
+    }
+    job->count += result->frames;
+    job->error += result->errors;
+    job->corrected += result->corrected;
 }
 
-// 디코딩된 데이터를 파일에 쓰기
-void write_binary_data_to_file(char *decoded, FILE *fout)
-{
-    char copy[9];
-	while (*decoded) {  // 디코딩된 데이터가 끝날 때까지 반복
-		unsigned char num = 0;
-		strncpy(copy, decoded, 8);  // 8비트 복사
-		copy[8] = '\0';
-        num = convert_binary_string_to_char(copy);  // 이진 문자열을 unsigned char로 변환
-		decoded += 8;  // 다음 8비트로 이동
-		fwrite(&num, sizeof(char), 1, fout);  // 파일에 한 바이트씩 쓰기
-	}
+// 입력 파일 전체를 메모리에 매핑한다. 매핑할 수 없는 입력(파이프 등)은 읽어서 담는다
+// *mapped는 munmap이 필요한지 여부
+const uint8_t *map_input(FILE *input_file, size_t *size, int *mapped) {
+    struct stat st;
+    int fd = fileno(input_file);
+    *mapped = 0;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        *size = (size_t)st.st_size;
+        if (*size == 0) return NULL;
+        void *p = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, *size, MADV_SEQUENTIAL);
+            *mapped = 1;
+            return (const uint8_t *)p;
+        }
+    }
+
+    size_t cap = CHUNK_SIZE, n;
+    uint8_t *data = (uint8_t *)malloc(cap);
+    if (!data) {
+        perror("memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    *size = 0;
+    while ((n = fread(data + *size, 1, cap - *size, input_file)) > 0) {
+        *size += n;
+        if (*size == cap) {
+            cap *= 2;
+            data = (uint8_t *)realloc(data, cap);
+            if (!data) {
+                perror("memory allocation error");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    return data;
 }
 
 FILE *open_file(const char *filename, const char *mode) {
@@ -74,13 +197,284 @@ FILE *open_file(const char *filename, const char *mode) {
     return file;  // 열린 파일의 포인터 반환
 }
 
+// 입력 하나를 디코딩하는 작업 정보 설정
+void init_decode_job(DecodeJob *job, const CrcEngine *engine, crc_decode_fn decode, const CrcSyndromes *fix,
+                     const uint8_t *input, size_t input_size, int dataword_size, FILE *output_file) {
+    job->engine = engine;
+    job->decode = decode;
+    job->fix = fix;
+    job->input = input;
+    job->total_bits = (uint64_t)input_size * 8;
+    job->start_bit = bits_data_start(input, input_size); // 첫 바이트는 패딩 크기
+    job->dataword_size = dataword_size;
+    job->frame_size = dataword_size + engine->width; // 프레임 크기 계산
+    job->frames_per_chunk = (CHUNK_BITS / job->frame_size + 7) / 8 * 8;
+    job->frame_count = job->total_bits > job->start_bit ? (job->total_bits - job->start_bit + job->frame_size - 1) / job->frame_size : 0;
+    job->output_file = output_file;
+    job->count = 0;
+    job->error = 0;
+    job->corrected = 0;
+    job->index_file = NULL;
+    job->run_start = 0;
+    job->run_len = 0;
+    job->run_end = 0;
+}
+
+// 결과 한 줄 기록 (-c 이면 정정한 수까지)
+void write_counts(FILE *result_file, const DecodeJob *job, int correct) {
+    if (correct)
+        fprintf(result_file, "%lld %lld %lld\n", job->count, job->error, job->corrected); // 총 프레임 수, 검출한 에러 수, 정정한 수
+    else
+        fprintf(result_file, "%lld %lld\n", job->count, job->error); // 결과 파일에 총 프레임 수와 에러 수 기록
+}
+
+// 일괄 처리할 파일 하나 (output, result 는 없으면 NULL)
+typedef struct {
+    char *input;
+    char *output;
+    char *result;
+} BatchEntry;
+
+// 일괄 처리 작업 정보: 생성기 표와 작업 버퍼는 모든 파일이 함께 씀
+typedef struct {
+    const CrcEngine *engine;
+    crc_decode_fn decode;
+    const CrcSyndromes *fix;
+    int dataword_size;
+    BatchEntry *entries;
+    uint64_t entry_count;
+    FILE *result_file;
+    long long failed;           // 열지 못한 파일 수
+} BatchJob;
+
+// 파일 하나를 디코딩 (작업 스레드마다 파일 하나씩, 청크 결과 버퍼는 슬롯별로 재사용)
+void decode_file(void *arg, uint64_t index, ChunkResult *result) {
+    BatchJob *batch = (BatchJob *)arg;
+    BatchEntry *entry = &batch->entries[index];
+    FILE *input_file = fopen(entry->input, "rb");
+    FILE *output_file = entry->output ? fopen(entry->output, "wb") : NULL;
+    if (!input_file || (entry->output && !output_file)) {
+        if (input_file) fclose(input_file);
+        if (output_file) fclose(output_file);
+        result->frames = -1; // 실패 표시
+        return;
+    }
+
+    size_t input_size;
+    int mapped;
+    const uint8_t *input = map_input(input_file, &input_size, &mapped);
+    DecodeJob job;
+    init_decode_job(&job, batch->engine, batch->decode, batch->fix, input, input_size, batch->dataword_size, output_file);
+    uint64_t chunk_count = (job.frame_count + job.frames_per_chunk - 1) / job.frames_per_chunk;
+    for (uint64_t i = 0; i < chunk_count; i++) {
+        result->len = 0;
+        decode_chunk(&job, i, result);
+        write_chunk(&job, i, result);
+    }
+    if (entry->result) {
+        FILE *result_file = fopen(entry->result, "w");
+        if (result_file) {
+            write_counts(result_file, &job, batch->fix != NULL);
+            fclose(result_file);
+        } else {
+            job.count = -1;
+        }
+    }
+
+    if (mapped) munmap((void *)input, input_size);
+    else free((void *)input);
+    fclose(input_file);
+    if (output_file) fclose(output_file);
+    result->len = 0;
+    result->frames = job.count;
+    result->errors = job.error;
+    result->corrected = job.corrected;
+}
+
+// 파일별 결과를 목록 순서대로 통합 결과 파일에 기록
+void write_file_result(void *arg, uint64_t index, ChunkResult *result) {
+    BatchJob *batch = (BatchJob *)arg;
+    const char *name = batch->entries[index].input;
+    if (result->frames < 0) {
+        fprintf(batch->result_file, "%s file open error\n", name);
+        batch->failed++;
+    } else if (batch->fix) {
+        fprintf(batch->result_file, "%s %lld %lld %lld\n", name, result->frames, result->errors, result->corrected);
+    } else {
+        fprintf(batch->result_file, "%s %lld %lld\n", name, result->frames, result->errors);
+    }
+}
+
+int compare_names(const void *a, const void *b) {
+    return strcmp(((const BatchEntry *)a)->input, ((const BatchEntry *)b)->input);
+}
+
+// 목록 파일("입력 [출력 [결과]]" 한 줄에 파일 하나) 또는 디렉터리(안의 일반 파일 전부, 검사만)를 읽음
+BatchEntry *load_batch(const char *source, uint64_t *count) {
+    size_t cap = 64;
+    BatchEntry *entries = (BatchEntry *)malloc(cap * sizeof(BatchEntry));
+    if (!entries) {
+        perror("memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    *count = 0;
+
+    struct stat st;
+    if (stat(source, &st) == 0 && S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(source);
+        if (!dir) {
+            fprintf(stderr, "batch directory open error.\n");
+            exit(1);
+        }
+        struct dirent *ent;
+        while ((ent = readdir(dir)) != NULL) {
+            size_t len = strlen(source) + strlen(ent->d_name) + 2;
+            char *path = (char *)malloc(len);
+            if (!path) {
+                perror("memory allocation error");
+                exit(EXIT_FAILURE);
+            }
+            snprintf(path, len, "%s/%s", source, ent->d_name);
+            if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+                free(path);
+                continue;
+            }
+            if (*count == cap) {
+                cap *= 2;
+                entries = (BatchEntry *)realloc(entries, cap * sizeof(BatchEntry));
+                if (!entries) {
+                    perror("memory allocation error");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            entries[*count].input = path;
+            entries[*count].output = NULL;
+            entries[*count].result = NULL;
+            (*count)++;
+        }
+        closedir(dir);
+        qsort(entries, *count, sizeof(BatchEntry), compare_names); // 결과 순서를 일정하게
+        return entries;
+    }
+
+    FILE *list = fopen(source, "r");
+    if (!list) {
+        fprintf(stderr, "batch list open error.\n");
+        exit(1);
+    }
+    char line[4096];
+    while (fgets(line, sizeof(line), list)) {
+        char *fields[3] = {NULL, NULL, NULL};
+        int n = 0;
+        for (char *tok = strtok(line, " \t\r\n"); tok && n < 3; tok = strtok(NULL, " \t\r\n")) fields[n++] = tok;
+        if (n == 0 || fields[0][0] == '#') continue; // 빈 줄, 주석
+        if (*count == cap) {
+            cap *= 2;
+            entries = (BatchEntry *)realloc(entries, cap * sizeof(BatchEntry));
+            if (!entries) {
+                perror("memory allocation error");
+                exit(EXIT_FAILURE);
+            }
+        }
+        entries[*count].input = strdup(fields[0]);
+        entries[*count].output = fields[1] && strcmp(fields[1], "-") != 0 ? strdup(fields[1]) : NULL;
+        entries[*count].result = fields[2] ? strdup(fields[2]) : NULL;
+        (*count)++;
+    }
+    fclose(list);
+    return entries;
+}
+
+// 생성기와 데이터워드 크기 검사, 생성기 표와 (-c 이면) 신드롬 표 생성
+void setup_codec(const char *generator, const char *dataword, int correct, CrcEngine *engine, CrcSyndromes *syndromes,
+                 int *dataword_size) {
+    *dataword_size = atoi(dataword); // 데이터워드 크기 파싱
+    if (*dataword_size < 1 || *dataword_size > CRC_MAX_DATAWORD) // 데이터워드 크기 유효성 검사
+    {
+        fprintf(stderr, "dataword size must be between 1 and %d.\n", CRC_MAX_DATAWORD);
+        exit(1);
+    }
+
+    if (crc_engine_init_cached(engine, generator) != 0) // 생성기 테이블 생성 (캐시 사용)
+    {
+        fprintf(stderr, "generator must be a binary string of 1 to %d bits.\n", CRC_MAX_WIDTH + 1);
+        exit(1);
+    }
+
+    if (correct && crc_syndrome_init_cached(syndromes, engine, generator, (uint64_t)*dataword_size + engine->width) != 0) // 신드롬 표 생성
+    {
+        fprintf(stderr, "generator cannot correct single-bit errors in %d-bit frames.\n", *dataword_size + engine->width);
+        exit(1);
+    }
+}
+
+void usage(void) {
+    fprintf(stderr, "usage: ./crc_decoder [-c] [-j threads] [-x index_file] input_file output_file result_file generator dataword_size\n");
+    fprintf(stderr, "       ./crc_decoder [-c] [-j threads] -b list_file|directory result_file generator dataword_size\n");
+    exit(1);
+}
+
 int main(int argc, char *argv[])
 {
     // 초기 설정
-    if (argc != 6)
+    int threads = 1; // 작업 스레드 수 (일괄 처리에서는 동시에 처리하는 파일 수)
+    int correct = 0; // 단일 비트 오류 정정 여부
+    const char *batch = NULL; // 일괄 처리 목록 파일 또는 디렉터리
+    const char *index_name = NULL; // 오류 프레임 색인 파일
+    int opt;
+    while ((opt = getopt(argc, argv, "b:cj:x:")) != -1)
     {
-        fprintf(stderr, "usage: ./crc_decoder input_file output_file result_file generator dataword_size\n");
-        exit(1);
+        if (opt == 'b')
+            batch = optarg;
+        else if (opt == 'x')
+            index_name = optarg;
+        else if (opt == 'c')
+            correct = 1;
+        else if (opt == 'j' && atoi(optarg) > 0)
+            threads = atoi(optarg);
+        else
+            usage();
+    }
+    if (argc - optind != (batch ? 3 : 5) || (batch && index_name))
+        usage();
+    argv += optind - 1; // argv[1] ~ 가 위치 인자를 가리키도록
+
+    CrcEngine engine;
+    CrcSyndromes syndromes;
+    int dataword_size;
+    crc_decode_fn decode;
+
+    if (batch) // 여러 파일을 한 번에 처리: 프로세스, 생성기 표, 버퍼를 모두 재사용
+    {
+        FILE *result_file = fopen(argv[1], "w"); // 통합 결과 파일 열기
+        if (result_file == NULL)
+        {
+            fprintf(stderr, "result file open error.\n");
+            exit(1);
+        }
+        setup_codec(argv[2], argv[3], correct, &engine, &syndromes, &dataword_size);
+        crc_select_frames(&engine, dataword_size, NULL, &decode);
+
+        BatchJob job;
+        job.engine = &engine;
+        job.decode = decode;
+        job.fix = correct ? &syndromes : NULL;
+        job.dataword_size = dataword_size;
+        job.entries = load_batch(batch, &job.entry_count);
+        job.result_file = result_file;
+        job.failed = 0;
+        chunk_pool_run(threads, job.entry_count, decode_file, write_file_result, &job); // 파일 하나가 청크 하나
+
+        for (uint64_t i = 0; i < job.entry_count; i++) {
+            free(job.entries[i].input);
+            free(job.entries[i].output);
+            free(job.entries[i].result);
+        }
+        free(job.entries);
+        if (correct) crc_syndrome_free(&syndromes);
+        crc_engine_free(&engine);
+        fclose(result_file);
+        return job.failed ? 1 : 0;
     }
 
     FILE *input_file = open_file(argv[1], "rb");
@@ -93,82 +487,46 @@ int main(int argc, char *argv[])
         exit(1);
     }
 
-    int dataword_size = atoi(argv[5]); // 데이터워드 크기 파싱
-    if (dataword_size != 4 && dataword_size != 8) // 데이터워드 크기 유효성 검사
+    setup_codec(argv[4], argv[5], correct, &engine, &syndromes, &dataword_size);
+    crc_select_frames(&engine, dataword_size, NULL, &decode);
+
+    size_t input_size; // 입력 데이터 길이
+    int mapped;
+    const uint8_t *input = map_input(input_file, &input_size, &mapped);
+
+    DecodeJob job;
+    init_decode_job(&job, &engine, decode, correct ? &syndromes : NULL, input, input_size, dataword_size, output_file);
+    if (index_name)
     {
-        fprintf(stderr, "dataword size must be 4 or 8.\n");
-        exit(1);
+        job.index_file = fopen(index_name, "wb");
+        if (job.index_file == NULL)
+        {
+            fprintf(stderr, "index file open error.\n");
+            exit(1);
+        }
+        write_index_header(&job);
     }
 
-    int count = 0; // 프레임 카운트
-    int pad_n = 0; // 패딩 크기
-    unsigned char buf; // 버퍼
-    char *generator = (char*)calloc(strlen(argv[4]) + 1, 1); // 생성기 메모리 할당
-    if (!generator) {
-        fclose(input_file);
-        fclose(output_file);
-        fclose(result_file);
-        perror("memory allocation error");
-        exit(EXIT_FAILURE);
-    }
-    strcpy(generator, argv[4]); // 생성기 복사
-    char *input_binary = (char*)malloc(MAX); // 입력 데이터를 이진 문자열로 저장할 메모리 할당
-    if (!input_binary) {
-        fclose(input_file);
-        fclose(output_file);
-        fclose(result_file);
-        free(generator);
-        perror("memory allocation error");
-        exit(EXIT_FAILURE);
-    }
-    input_binary[0] = '\0';
-    int input_n = 0; // 입력 데이터 길이
-    while (fread(&buf, 1, 1, input_file) != 0)
+    // 프레임을 청크로 나눠 검사하고 순서대로 출력
+    uint64_t chunk_count = (job.frame_count + job.frames_per_chunk - 1) / job.frames_per_chunk;
+    chunk_pool_run(threads, chunk_count, decode_chunk, write_chunk, &job);
+    write_counts(result_file, &job, correct);
+    if (job.index_file)
     {
-        if (count == 0)
-            pad_n = buf; // 첫 바이트는 패딩 크기
-        else 
+        flush_index_run(&job);
+        if (fclose(job.index_file) != 0)
         {
-            char *buf_binary = convert_decimal_to_binary_string((int)buf); // 버퍼를 이진 문자열로 변환
-            strcat(input_binary, buf_binary); // 이진 문자열 추가
+            perror("index file write error");
+            exit(EXIT_FAILURE);
         }
-        count++;
-    }
-    input_binary += pad_n; // 패딩 제거
-    int frame_size = dataword_size + strlen(generator) - 1; // 프레임 크기 계산
-    char *frame = (char*)calloc(frame_size + 1, 1); // 프레임 메모리 할당
-    if (!frame) {
-        fclose(input_file);
-        fclose(output_file);
-        fclose(result_file);
-        free(generator);
-        free(input_binary);
-        perror("memory allocation error");
-        exit(EXIT_FAILURE);
     }
-    count = 0;
-    int error = 0; // 에러 카운트
-    char *decoded = (char*)calloc(MAX, 1); // 디코딩된 데이터 저장
-    if (!decoded) {
-        fclose(input_file);
-        fclose(output_file);
-        fclose(result_file);
-        free(generator);
-        free(input_binary);
-        free(frame);
-        perror("memory allocation error");
-        exit(EXIT_FAILURE);
-    }
-    for (int i = 0; input_binary[i]; i += frame_size) // 전체 입력 데이터를 프레임 크기만큼 반복
-    {
-        strncpy(frame, input_binary + i, frame_size);
-        frame[frame_size] = '\0';
-        if(calculate_crc_remainder(frame, generator)) // CRC 검사
-            error++;
-        count++;
-        strncat(decoded, frame, dataword_size); // 디코딩된 데이터 추가
-    }
-    write_binary_data_to_file(decoded, output_file); // 파일에 디코딩된 데이터 쓰기
-    fprintf(result_file,"%d %d\n", count, error); // 결과 파일에 총 프레임 수와 에러 수 기록
+
+    if (mapped) munmap((void *)input, input_size);
+    else free((void *)input);
+    if (correct) crc_syndrome_free(&syndromes);
+    crc_engine_free(&engine);
+    fclose(input_file);
+    fclose(output_file);
+    fclose(result_file);
     return (0);
 }
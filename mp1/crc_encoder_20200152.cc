@@ -2,94 +2,106 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
 #include <sys/types.h>
-
-#define MAX 2 * 20 * 20 * 512 * 512
-
-// 정수를 이진 문자열로 변환
-char *convert_decimal_to_binary_string(int n)
-{
-    char *binary_str = (char *)malloc(9 * sizeof(char)); // 9바이트 메모리 할당 (8비트 + 종료문자)
-    if (!binary_str) {
-        perror("memory allocation error"); // 메모리 할당 실패 오류 출력
-        exit(EXIT_FAILURE);
-    }
-    binary_str[8] = '\0'; // 문자열 종료 문자 설정
-
-    for (int i = 7; i >= 0; i--) // 8비트까지
-    {
-        binary_str[i] = (n & 1) + '0'; // 최하위 비트를 문자로 변환
-        n = n >> 1; // 오른쪽으로 한 비트 시프트
-    }
-
-    return binary_str;
-}
-
-// 나머지를 계산하는 함수
-char *calculate_crc_remainder(char *dataword, char *generator) {
-    int d_len = strlen(dataword);
-    int g_len = strlen(generator);
-    int r_len = g_len - 1;
-    char *dividend = (char *)malloc(d_len + r_len + 1);
-    if (!dividend) {
-        perror("Memory allocation error");
-        exit(EXIT_FAILURE);
-    }
-    strcpy(dividend, dataword);
-    memset(dividend + d_len, '0', r_len);
-    dividend[d_len + r_len] = '\0';
-
-    for (int i = 0; i < d_len; i++) {
-        if (dividend[i] == '1') {
-            for (int j = 0; j < g_len; j++) {
-                dividend[i + j] ^= generator[j] ^ '0';
-            }
+#include <sys/stat.h>
+
+#include "crc_frame.h"
+#include "crc_table_cache.h"
+#include "chunk_pool.h"
+
+#define CHUNK_SIZE (64 * 1024) // 파이프 입력을 옮겨 담을 때 쓰는 버퍼 크기
+#define CHUNK_BITS (8 << 20)   // 청크 하나의 대략적인 출력 비트 수
+
+// 청크 작업에 필요한 공용 정보
+typedef struct {
+    const CrcEngine *engine;
+    crc_encode_fn encode;      // 데이터워드 크기에 맞게 선택된 프레임 루프
+    int input_fd;
+    uint64_t input_size;
+    int dataword_size;
+    uint64_t frames_per_chunk; // 8의 배수라서 청크 출력은 항상 바이트 단위로 끝남
+    uint64_t frame_count;
+    int lead_bits;             // 청크 출력 앞에 오는 이전 바이트의 비트 수 (패딩 % 8)
+    FILE *output_file;
+    uint8_t carry;             // 다음 청크 첫 바이트와 합칠 비트
+    int carry_bits;
+} EncodeJob;
+
+// 청크 하나를 코드워드로 변환
+void encode_chunk(void *arg, uint64_t index, ChunkResult *result) {
+    EncodeJob *job = (EncodeJob *)arg;
+    const CrcEngine *engine = job->engine;
+    int d = job->dataword_size;
+    uint64_t first = index * job->frames_per_chunk;
+    uint64_t frames = job->frame_count - first < job->frames_per_chunk ? job->frame_count - first : job->frames_per_chunk;
+    uint64_t offset = first * d / 8;
+    size_t in_len = (size_t)((frames * d + 7) / 8);
+    if (offset + in_len > job->input_size) in_len = (size_t)(job->input_size - offset);
+
+    size_t padded_len = (size_t)((frames * d + 7) / 8); // 마지막 데이터워드는 0으로 채움
+    chunk_reserve(&result->scratch, &result->scratch_cap, padded_len + 8);
+    memset(result->scratch + in_len, 0, padded_len + 8 - in_len);
+    size_t done = 0;
+    while (done < in_len) { // 청크 입력 읽기
+        ssize_t n = pread(job->input_fd, result->scratch + done, in_len - done, (off_t)(offset + done));
+        if (n <= 0) {
+            perror("input file read error");
+            exit(EXIT_FAILURE);
         }
+        done += (size_t)n;
     }
 
-    char *remainder = strdup(dividend + d_len);
-    free(dividend);
-    if (!remainder) {
-        perror("Memory allocation error");
-        exit(EXIT_FAILURE);
-    }
-    return remainder;
+    chunk_reserve(&result->data, &result->cap, (size_t)((job->lead_bits + frames * (d + engine->width)) / 8) + 16);
+    BitWriter w = {result->data, 0, 0, job->lead_bits}; // 앞 비트 자리는 0으로 비워 둠
+    job->encode(engine, d, result->scratch, frames, &w); // 코드워드 생성
+    finish_bits(&w);
+    result->len = w.len;
+    result->frames = (long long)frames;
 }
 
-// 코드워드 생성 함수
-char *generate_codeword(char *dataword, char *generator) {
-    char *remainder = calculate_crc_remainder(dataword, generator);
-    char *codeword = (char *)malloc(strlen(dataword) + strlen(remainder) + 1);
-    if (!codeword) {
-        free(remainder);
-        perror("Memory allocation error");
+// 청크 출력을 순서대로 파일에 기록 (앞 청크의 마지막 바이트와 이어 붙임)
+void write_chunk(void *arg, uint64_t index, ChunkResult *result) {
+    EncodeJob *job = (EncodeJob *)arg;
+    (void)index;
+    if (result->len == 0) return;
+    int tail = (int)((job->lead_bits + result->frames * (job->dataword_size + job->engine->width)) % 8); // 마지막 바이트에 찬 비트 수
+    result->data[0] |= job->carry;
+    size_t full = tail ? result->len - 1 : result->len;
+    if (fwrite(result->data, 1, full, job->output_file) != full) {
+        perror("output file write error");
         exit(EXIT_FAILURE);
     }
-    strcpy(codeword, dataword);
-    strcat(codeword, remainder);
-    free(remainder);
-    return codeword;
+    job->carry = tail ? result->data[full] : 0;
+    job->carry_bits = tail;
 }
 
-int convert_binary_to_decimal(char *binary) {
-    int num = 0, bin = 1;
-    for (int i = 7; i >= 0; i--) {
-        num += (binary[i] == '1') ? bin : 0;
-        bin <<= 1;
+// 입력 크기를 구한다. 일반 파일이 아니면 (파이프 등) 임시 파일에 옮겨 담은 뒤 크기를 센다
+FILE *prepare_input(FILE *input_file, uint64_t *size) {
+    struct stat st;
+    if (fstat(fileno(input_file), &st) == 0 && S_ISREG(st.st_mode)) {
+        *size = (uint64_t)st.st_size;
+        return input_file;
     }
-    return num;
-}
 
-// 이진 파일에 쓰기
-void write_binary_data_to_file(char *code, FILE *fout) {
-    while (*code) {
-        char byte_segment[9];
-        strncpy(byte_segment, code, 8);
-        byte_segment[8] = '\0';
-        code += 8;
-        int num = convert_binary_to_decimal(byte_segment);
-        fputc(num, fout);
+    FILE *spool = tmpfile();
+    if (!spool) {
+        perror("temporary file error");
+        exit(EXIT_FAILURE);
     }
+    uint8_t buf[CHUNK_SIZE];
+    size_t n;
+    *size = 0;
+    while ((n = fread(buf, 1, sizeof(buf), input_file)) > 0) {
+        if (fwrite(buf, 1, n, spool) != n) {
+            perror("temporary file error");
+            exit(EXIT_FAILURE);
+        }
+        *size += n;
+    }
+    fclose(input_file);
+    fflush(spool);
+    return spool;
 }
 
 FILE *open_file(const char *filename, const char *mode) {
@@ -104,100 +116,80 @@ FILE *open_file(const char *filename, const char *mode) {
 int main(int argc, char *argv[])
 {
     // 초기 설정
-    if (argc != 5) // 인자 개수가 5개가 아니면
+    int threads = 1; // 작업 스레드 수
+    int opt;
+    while ((opt = getopt(argc, argv, "j:")) != -1)
     {
-        fprintf(stderr, "usage: ./crc_encoder input_file output_file generator dataword_size\n"); // 사용법 출력
+        if (opt == 'j' && atoi(optarg) > 0)
+            threads = atoi(optarg);
+        else
+        {
+            fprintf(stderr, "usage: ./crc_encoder [-j threads] input_file output_file generator dataword_size\n");
+            exit(1);
+        }
+    }
+    if (argc - optind != 4) // 인자 개수가 4개가 아니면
+    {
+        fprintf(stderr, "usage: ./crc_encoder [-j threads] input_file output_file generator dataword_size\n"); // 사용법 출력
         exit(1);
     }
+    argv += optind - 1; // argv[1] ~ argv[4]가 위치 인자를 가리키도록
 
     FILE *input_file = open_file(argv[1], "rb");
     FILE *output_file = open_file(argv[2], "wb");
 
     int dataword_size = atoi(argv[4]); // 데이터워드 크기 읽기
-    if (dataword_size != 4 && dataword_size != 8) // 4 또는 8이 아니면
+    if (dataword_size < 1 || dataword_size > CRC_MAX_DATAWORD) // 데이터워드 크기 유효성 검사
     {
-        fprintf(stderr, "dataword size must be 4 or 8.\n"); // 오류 메시지 출력
+        fprintf(stderr, "dataword size must be between 1 and %d.\n", CRC_MAX_DATAWORD);
         exit(1);
     }
 
-    char *generator = (char *)malloc(strlen(argv[3]) + 1); // 생성기 메모리 할당
-    if (!generator) {
-        fclose(input_file);
-        fclose(output_file);
-        perror("memory allocation error"); // 메모리 할당 실패 오류 출력
-        exit(EXIT_FAILURE);
+    CrcEngine engine;
+    if (crc_engine_init_cached(&engine, argv[3]) != 0) // 생성기 테이블 생성 (캐시 사용)
+    {
+        fprintf(stderr, "generator must be a binary string of 1 to %d bits.\n", CRC_MAX_WIDTH + 1);
+        exit(1);
     }
-    strcpy(generator, argv[3]); // 생성기 복사
-
-    char buf;
-    char *final_code = (char *)calloc(MAX, 1); // 최종 코드 메모리 할당
-    if (!final_code) {
-        fclose(input_file);
-        fclose(output_file);
-        free(generator);
-        perror("memory allocation error"); // 메모리 할당 실패 오류 출력
+
+    // 입력 크기로부터 패딩 크기를 미리 계산
+    uint64_t input_size;
+    input_file = prepare_input(input_file, &input_size);
+    uint64_t frame_count = (input_size * 8 + dataword_size - 1) / dataword_size; // 마지막 데이터워드는 0으로 채움
+    uint64_t frame_size = dataword_size + engine.width;
+    uint64_t code_bits = frame_count * frame_size;
+    int pad_size = bits_pad_size(code_bits); // 패딩 크기 계산
+
+    // 패딩 크기 바이트와 패딩 중 바이트를 채운 부분을 먼저 기록
+    uint8_t header[2];
+    size_t header_len = bits_pad_prefix(header, pad_size);
+    if (fwrite(header, 1, header_len, output_file) != header_len) {
+        perror("output file write error");
         exit(EXIT_FAILURE);
     }
-    char *code_word;
 
-    // 메인 루프
-    while (fread(&buf, 1, 1, input_file) != 0) // 파일에서 1바이트씩 읽기
-    {
-        char *buf_binary = convert_decimal_to_binary_string((int)buf); // 버퍼의 이진 문자열 변환
-        if (dataword_size == 8)
-            code_word = generate_codeword(buf_binary, generator); // 8비트 데이터워드로 코드워드 계산
-        else
-        {
-            char *temp_code_word[2];
-            for (int i = 0; i < 2; i++)
-            {
-                char dataword[5];
-                strncpy(dataword, buf_binary + i * 4, 4); // 4비트 추출
-                dataword[4] = '\0'; // 문자열 종료 문자 설정
-                temp_code_word[i] = generate_codeword(dataword, generator); // 코드워드 계산
-            }
-            // 두 개의 코드워드를 하나로 합치기
-            code_word = (char *)malloc(strlen(temp_code_word[1]) * 2 + 1);
-            if (!code_word) 
-            {
-                fclose(input_file);
-                fclose(output_file);
-                free(final_code);
-                free(generator);
-                perror("memory allocation error"); // 메모리 할당 실패 오류 출력
-                exit(EXIT_FAILURE);
-            }
-
-            code_word[0] = '\0';
-            strcat(code_word, temp_code_word[0]); // 첫 번째 코드워드 추가
-            strcat(code_word, temp_code_word[1]); // 두 번째 코드워드 추가
-            free(temp_code_word[0]); // 사용한 메모리 해제
-            free(temp_code_word[1]); // 사용한 메모리 해제
-        }
-        strcat(final_code, code_word); // 최종 코드에 추가
-        free(code_word); // 사용한 메모리 해제
-        free(buf_binary); // 사용한 메모리 해제
-    }
-    int pad_size = 16 - (strlen(final_code) % 16); // 패딩 크기 계산
-    if (pad_size == 16)
-        pad_size = 0;
-    char *padding = (char *)malloc(pad_size + 1);
-    memset(padding, '0', pad_size); // 패딩으로 0 채우기
-    padding[pad_size] = '\0'; // 문자열 종료 문자 설정
-    char *pad_n = convert_decimal_to_binary_string(pad_size); // 패딩 크기 이진 문자열 변환
-    char *print = (char *)malloc(strlen(pad_n) + strlen(padding) + strlen(final_code) + 1); // 최종 문자열 메모리 할당
-    if (!print) {
-        perror("memory allocation error"); // 메모리 할당 실패 오류 출력
+    EncodeJob job;
+    job.engine = &engine;
+    crc_select_frames(&engine, dataword_size, &job.encode, NULL);
+    job.input_fd = fileno(input_file);
+    job.input_size = input_size;
+    job.dataword_size = dataword_size;
+    job.frames_per_chunk = (CHUNK_BITS / frame_size + 7) / 8 * 8;
+    job.frame_count = frame_count;
+    job.lead_bits = pad_size % 8;
+    job.output_file = output_file;
+    job.carry = 0;
+    job.carry_bits = job.lead_bits;
+
+    // 메인 루프: 청크 단위로 코드워드를 만들고 순서대로 출력
+    uint64_t chunk_count = (frame_count + job.frames_per_chunk - 1) / job.frames_per_chunk;
+    chunk_pool_run(threads, chunk_count, encode_chunk, write_chunk, &job);
+    if (job.carry_bits && fwrite(&job.carry, 1, 1, output_file) != 1) {
+        perror("output file write error");
         exit(EXIT_FAILURE);
     }
-    print[0] = '\0';
-    strcat(print, pad_n); // 패딩 크기 추가
-    strcat(print, padding); // 패딩 추가
-    strcat(print, final_code); // 최종 코드 추가
-    write_binary_data_to_file(print, output_file); // 이진 파일에 쓰기
-    free(pad_n); // 사용한 메모리 해제
-    free(padding); // 사용한 메모리 해제
-    free(final_code); // 사용한 메모리 해제
+
+    crc_engine_free(&engine);
     fclose(input_file); // 파일 닫기
     fclose(output_file); // 파일 닫기
 }
@@ -0,0 +1,328 @@
+#ifndef CRC_ENGINE_H
+#define CRC_ENGINE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "bitstream.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CRC_HAVE_CLMUL 1
+#endif
+
+// 패킹된 비트열을 대상으로 하는 CRC 엔진 (crc_encoder / crc_decoder 공용)
+//
+// 비트열은 바이트 내 MSB 우선으로 패킹되어 있고, 나머지(레지스터)는 64비트 워드의
+// 최상위 비트부터 채우는 left-aligned 형식으로 다룬다. 이렇게 하면 생성기 길이와
+// 상관없이 같은 테이블 방식(바이트 단위, slicing-by-8)을 쓸 수 있다.
+//
+// 기존 문자열 나눗셈에서 생성기의 첫 비트는 결과에 영향을 주지 않으므로
+// (검사한 뒤의 비트만 XOR 됨) 레지스터에는 첫 비트를 제외한 나머지 비트만 둔다.
+
+#define CRC_MAX_WIDTH 4096 // 지원하는 최대 나머지 비트 수
+#define CRC_MAX_WORDS (CRC_MAX_WIDTH / 64)
+#define CRC_SLICES 8 // slicing-by-8
+#define CRC_CLMUL_MIN 128 // carry-less multiply 접기를 쓰는 최소 바이트 수
+
+typedef struct {
+    int width;                            // 나머지 비트 수 (생성기 길이 - 1)
+    int words;                            // 나머지를 담는 64비트 워드 수
+    uint64_t poly;                        // 첫 비트를 제외한 생성기 (width <= 64, left-aligned)
+    uint64_t mask;                        // 나머지 비트 마스크 (width <= 64)
+    const uint64_t (*table)[256];         // table[k][b]: 바이트 b 뒤에 0 바이트 k개를 처리한 결과 (CRC_SLICES 개)
+    uint64_t half[16];                    // 4비트 단위 테이블
+    int use_clmul;                        // PCLMULQDQ 접기 사용 여부 (실행 시 CPU 확인)
+    uint64_t fold[8];                     // 접기 상수: x^(D+64), x^D mod G (D = 512, 384, 256, 128)
+    uint64_t *wide_poly;                  // width > 64 인 생성기 (words 워드)
+    const uint64_t *wide_table;           // width > 64 인 경우 바이트 테이블 (256 * words)
+    uint64_t *owned;                      // 직접 만든 테이블 메모리 (캐시에서 매핑했으면 NULL)
+    void *map;                            // 캐시 파일 매핑 (crc_table_cache.h)
+    size_t map_len;
+} CrcEngine;
+
+// 한 비트 처리 (입력 비트는 미리 최상위 비트에 XOR 되어 있어야 함)
+static inline uint64_t crc_step_bit(uint64_t crc, uint64_t poly)
+{
+    return (crc << 1) ^ (poly & (0 - (crc >> 63)));
+}
+
+// 좁은 생성기(width <= 64)용: bits의 상위 nbits(< 8) 비트 처리
+static inline uint64_t crc_update_bits(const CrcEngine *e, uint64_t crc, uint64_t bits, int nbits)
+{
+    crc ^= bits;
+    if (nbits >= 4) {
+        crc = (crc << 4) ^ e->half[crc >> 60];
+        nbits -= 4;
+    }
+    while (nbits-- > 0) {
+        crc = crc_step_bit(crc, e->poly);
+    }
+    return crc;
+}
+
+// 좁은 생성기(width <= 64)용: 바이트 배열 처리 (slicing-by-8)
+static inline uint64_t crc_update_bytes(const CrcEngine *e, uint64_t crc, const uint8_t *p, size_t n)
+{
+    while (n >= 8) {
+        crc ^= load_be64(p);
+        crc = e->table[7][crc >> 56] ^ e->table[6][(crc >> 48) & 0xff] ^
+              e->table[5][(crc >> 40) & 0xff] ^ e->table[4][(crc >> 32) & 0xff] ^
+              e->table[3][(crc >> 24) & 0xff] ^ e->table[2][(crc >> 16) & 0xff] ^
+              e->table[1][(crc >> 8) & 0xff] ^ e->table[0][crc & 0xff];
+        p += 8;
+        n -= 8;
+    }
+    while (n--) {
+        crc = (crc << 8) ^ e->table[0][(crc >> 56) ^ *p++];
+    }
+    return crc;
+}
+
+#ifdef CRC_HAVE_CLMUL
+// PCLMULQDQ 기반 접기(folding): 128비트 누산기 4개로 64바이트씩 접은 뒤 하나로 합치고,
+// 마지막 16바이트는 테이블로 나눈다. 레지스터가 64비트 다항식 x^64 + poly 에 대한
+// 나머지이므로 생성기 길이(1 ~ 64비트)와 상관없이 같은 상수 계산이 적용된다.
+__attribute__((target("pclmul,ssse3")))
+static uint64_t crc_clmul_update(const CrcEngine *e, uint64_t crc, const uint8_t *p, size_t n)
+{
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i k512 = _mm_set_epi64x((long long)e->fold[0], (long long)e->fold[1]);
+    const __m128i k384 = _mm_set_epi64x((long long)e->fold[2], (long long)e->fold[3]);
+    const __m128i k256 = _mm_set_epi64x((long long)e->fold[4], (long long)e->fold[5]);
+    const __m128i k128 = _mm_set_epi64x((long long)e->fold[6], (long long)e->fold[7]);
+#define CRC_LOAD(i) _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + 16 * (i))), bswap)
+#define CRC_FOLD(x, k) _mm_xor_si128(_mm_clmulepi64_si128((x), (k), 0x11), _mm_clmulepi64_si128((x), (k), 0x00))
+
+    __m128i x0 = _mm_xor_si128(CRC_LOAD(0), _mm_set_epi64x((long long)crc, 0)); // 기존 레지스터는 첫 64비트에 더함
+    __m128i x1 = CRC_LOAD(1), x2 = CRC_LOAD(2), x3 = CRC_LOAD(3);
+    p += 64;
+    n -= 64;
+    while (n >= 64) {
+        x0 = _mm_xor_si128(CRC_FOLD(x0, k512), CRC_LOAD(0));
+        x1 = _mm_xor_si128(CRC_FOLD(x1, k512), CRC_LOAD(1));
+        x2 = _mm_xor_si128(CRC_FOLD(x2, k512), CRC_LOAD(2));
+        x3 = _mm_xor_si128(CRC_FOLD(x3, k512), CRC_LOAD(3));
+        p += 64;
+        n -= 64;
+    }
+    __m128i x = _mm_xor_si128(_mm_xor_si128(CRC_FOLD(x0, k384), CRC_FOLD(x1, k256)),
+                              _mm_xor_si128(CRC_FOLD(x2, k128), x3));
+    while (n >= 16) {
+        x = _mm_xor_si128(CRC_FOLD(x, k128), CRC_LOAD(0));
+        p += 16;
+        n -= 16;
+    }
+#undef CRC_LOAD
+#undef CRC_FOLD
+
+    uint8_t last[16];
+    _mm_storeu_si128((__m128i *)last, _mm_shuffle_epi8(x, bswap));
+    crc = crc_update_bytes(e, 0, last, 16);
+    return crc_update_bytes(e, crc, p, n);
+}
+#endif
+
+// 바이트 배열 처리: 충분히 길고 CPU가 지원하면 접기 커널, 아니면 테이블
+static inline uint64_t crc_update_run(const CrcEngine *e, uint64_t crc, const uint8_t *p, size_t n)
+{
+#ifdef CRC_HAVE_CLMUL
+    if (e->use_clmul && n >= CRC_CLMUL_MIN) return crc_clmul_update(e, crc, p, n);
+#endif
+    return crc_update_bytes(e, crc, p, n);
+}
+
+// 넓은 생성기(width > 64)용: 레지스터 배열에 상위 nbits(<= 8) 비트 처리
+static inline void crc_wide_update_bits(const CrcEngine *e, uint64_t *st, uint64_t bits, int nbits)
+{
+    int w = e->words;
+    st[0] ^= bits;
+    if (nbits == 8) {
+        const uint64_t *t = e->wide_table + (size_t)(st[0] >> 56) * w;
+        for (int i = 0; i < w - 1; i++) st[i] = ((st[i] << 8) | (st[i + 1] >> 56)) ^ t[i];
+        st[w - 1] = (st[w - 1] << 8) ^ t[w - 1];
+        return;
+    }
+    while (nbits-- > 0) {
+        uint64_t top = 0 - (st[0] >> 63);
+        for (int i = 0; i < w - 1; i++) st[i] = ((st[i] << 1) | (st[i + 1] >> 63)) ^ (e->wide_poly[i] & top);
+        st[w - 1] = (st[w - 1] << 1) ^ (e->wide_poly[w - 1] & top);
+    }
+}
+
+// 생성기 문자열을 검사하고 테이블을 뺀 나머지(다항식, 작은 테이블, 접기 상수)를 채움
+// 잘못된 생성기면 -1 반환
+static inline int crc_engine_setup(CrcEngine *e, const char *generator)
+{
+    int g_len = (int)strlen(generator);
+    memset(e, 0, sizeof(*e));
+    if (g_len < 1 || g_len - 1 > CRC_MAX_WIDTH) return -1;
+    for (int i = 0; i < g_len; i++) {
+        if (generator[i] != '0' && generator[i] != '1') return -1;
+    }
+
+    e->width = g_len - 1;
+    e->words = e->width > 64 ? (e->width + 63) / 64 : 1;
+
+    if (e->width <= 64) {
+        for (int i = 1; i < g_len; i++) {
+            if (generator[i] == '1') e->poly |= 1ULL << (64 - i);
+        }
+        e->mask = e->width ? ~0ULL << (64 - e->width) : 0;
+
+        for (int v = 0; v < 16; v++) {
+            uint64_t crc = (uint64_t)v << 60;
+            for (int k = 0; k < 4; k++) crc = crc_step_bit(crc, e->poly);
+            e->half[v] = crc;
+        }
+
+        // 접기 상수: x^n mod (x^64 + poly) 는 1을 n비트 밀어서 얻는다
+        static const int dist[8] = {576, 512, 448, 384, 320, 256, 192, 128};
+        for (int k = 0; k < 8; k++) {
+            uint64_t crc = 1;
+            for (int i = 0; i < dist[k]; i++) crc = crc_step_bit(crc, e->poly);
+            e->fold[k] = crc;
+        }
+#ifdef CRC_HAVE_CLMUL
+        e->use_clmul = e->width > 0 && !getenv("CRC_DISABLE_CLMUL") &&
+                       __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+#endif
+        return 0;
+    }
+
+    e->wide_poly = (uint64_t *)calloc(e->words, sizeof(uint64_t));
+    if (!e->wide_poly) {
+        perror("memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 1; i < g_len; i++) {
+        if (generator[i] == '1') e->wide_poly[(i - 1) / 64] |= 1ULL << (63 - (i - 1) % 64);
+    }
+    return 0;
+}
+
+// 바이트 테이블의 워드 수 (좁은 생성기는 CRC_SLICES x 256, 넓은 생성기는 256 x words)
+static inline size_t crc_engine_table_words(const CrcEngine *e)
+{
+    return e->words == 1 ? (size_t)CRC_SLICES * 256 : (size_t)256 * e->words;
+}
+
+// 테이블 메모리 연결 (직접 만들었든 캐시에서 매핑했든)
+static inline void crc_engine_attach(CrcEngine *e, const uint64_t *tables)
+{
+    if (e->words == 1) e->table = (const uint64_t (*)[256])tables;
+    else e->wide_table = tables;
+}
+
+// crc_engine_setup 이 끝난 엔진의 바이트 테이블을 dst 에 계산
+static inline void crc_engine_fill_tables(const CrcEngine *e, uint64_t *dst)
+{
+    if (e->words == 1) {
+        uint64_t (*table)[256] = (uint64_t (*)[256])dst;
+        for (int b = 0; b < 256; b++) {
+            uint64_t crc = (uint64_t)b << 56;
+            for (int k = 0; k < 8; k++) crc = crc_step_bit(crc, e->poly);
+            table[0][b] = crc;
+        }
+        for (int k = 1; k < CRC_SLICES; k++) {
+            for (int b = 0; b < 256; b++) {
+                uint64_t crc = table[k - 1][b];
+                table[k][b] = (crc << 8) ^ table[0][crc >> 56];
+            }
+        }
+        return;
+    }
+
+    CrcEngine tmp = *e; // 비트 단위 처리만 쓰므로 바이트 테이블 없이 계산
+    int w = e->words;
+    for (int b = 0; b < 256; b++) { // 바이트 테이블은 비트 단위 처리로 채움
+        uint64_t *st = dst + (size_t)b * w;
+        memset(st, 0, w * sizeof(uint64_t));
+        st[0] = (uint64_t)b << 56;
+        for (int k = 0; k < 8; k++) crc_wide_update_bits(&tmp, st, 0, 1);
+    }
+}
+
+// 생성기 문자열로 엔진 초기화, 잘못된 생성기면 -1 반환
+static inline int crc_engine_init(CrcEngine *e, const char *generator)
+{
+    if (crc_engine_setup(e, generator) != 0) return -1;
+    e->owned = (uint64_t *)malloc(crc_engine_table_words(e) * sizeof(uint64_t));
+    if (!e->owned) {
+        perror("memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    crc_engine_fill_tables(e, e->owned);
+    crc_engine_attach(e, e->owned);
+    return 0;
+}
+
+static inline void crc_engine_free(CrcEngine *e)
+{
+    free(e->wide_poly);
+    free(e->owned);
+    if (e->map) munmap(e->map, e->map_len);
+    e->wide_poly = NULL;
+    e->owned = NULL;
+    e->map = NULL;
+    e->table = NULL;
+    e->wide_table = NULL;
+}
+
+// data의 bit_offset 비트부터 nbits 비트를 데이터워드로 보고 나머지를 rem에 기록
+// rem은 e->words 워드, left-aligned
+static inline void crc_engine_remainder(const CrcEngine *e, const uint8_t *data, uint64_t bit_offset, uint64_t nbits, uint64_t *rem)
+{
+    const uint8_t *p = data + (bit_offset >> 3);
+    int lead = (int)(bit_offset & 7);
+
+    if (e->words == 1) {
+        uint64_t crc = 0;
+        if (lead && nbits) { // 바이트 경계까지 앞부분 처리
+            int take = 8 - lead;
+            if ((uint64_t)take > nbits) take = (int)nbits;
+            crc = crc_update_bits(e, crc, load_bits(data, bit_offset, take), take);
+            nbits -= take;
+            p++;
+        }
+        crc = crc_update_run(e, crc, p, nbits >> 3);
+        p += nbits >> 3;
+        if (nbits & 7) crc = crc_update_bits(e, crc, load_bits(p, 0, nbits & 7), nbits & 7);
+        rem[0] = crc & e->mask;
+        return;
+    }
+
+    memset(rem, 0, e->words * sizeof(uint64_t));
+    if (lead && nbits) {
+        int take = 8 - lead;
+        if ((uint64_t)take > nbits) take = (int)nbits;
+        crc_wide_update_bits(e, rem, load_bits(data, bit_offset, take), take);
+        nbits -= take;
+        p++;
+    }
+    for (uint64_t i = 0; i < (nbits >> 3); i++) {
+        crc_wide_update_bits(e, rem, (uint64_t)*p++ << 56, 8);
+    }
+    if (nbits & 7) crc_wide_update_bits(e, rem, load_bits(p, 0, nbits & 7), nbits & 7);
+}
+
+// bit_offset에서 시작하는 프레임(data_bits 비트 데이터워드 + 나머지)의 오류 검사
+// 나머지가 0이 아니면 1 반환
+static inline int crc_engine_check(const CrcEngine *e, const uint8_t *data, uint64_t bit_offset, uint64_t data_bits)
+{
+    uint64_t rem[CRC_MAX_WORDS];
+    crc_engine_remainder(e, data, bit_offset, data_bits, rem);
+
+    uint64_t pos = bit_offset + data_bits;
+    int left = e->width;
+    for (int i = 0; left > 0; i++, left -= 64, pos += 64) {
+        int n = left < 64 ? left : 64;
+        if (rem[i] != load_bits(data, pos, n)) return 1;
+    }
+    return 0;
+}
+
+#endif
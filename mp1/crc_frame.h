@@ -0,0 +1,224 @@
+#ifndef CRC_FRAME_H
+#define CRC_FRAME_H
+
+#include "crc_engine.h"
+#include "crc_syndrome.h"
+
+// 프레임 계층: 데이터워드 + 나머지로 이루어진 코드워드를 만들고 검사한다 (crc_encoder / crc_decoder 공용)
+//
+// 데이터워드 크기는 1 ~ CRC_MAX_DATAWORD 비트 중 아무 값이나 쓸 수 있다.
+// 자주 쓰는 크기(4, 8, 16, 32, 64비트)와 좁은 생성기(64비트 이하) 조합은 템플릿으로
+// 컴파일 시 특수화해서, 프레임 루프 안에서 크기에 따른 분기 없이 테이블 조회만 한다.
+// 나머지 조합은 실행 시 크기를 받는 일반 경로를 쓴다.
+
+#define CRC_MAX_DATAWORD 65536 // 지원하는 최대 데이터워드 비트 수
+
+// 프레임 루프 함수: 인코더는 데이터워드 frames 개를 in 의 0비트부터 읽어 코드워드를 쓰고,
+// 디코더는 r 의 현재 위치부터 frames 개의 온전한 프레임을 검사해 데이터워드를 쓰고 오류 수를 반환
+// fix 가 있으면 단일 비트 오류를 고친 데이터워드를 쓰고 고친 프레임 수를 *corrected 에 더함
+// bad 가 있으면 (고치지 못한) 오류 프레임 번호를 이번 호출의 첫 프레임 기준으로 추가
+typedef struct {
+    uint64_t *items;
+    size_t count;
+    size_t cap;
+} CrcFrameList;
+
+typedef void (*crc_encode_fn)(const CrcEngine *e, int d, const uint8_t *in, uint64_t frames, BitWriter *w);
+typedef uint64_t (*crc_decode_fn)(const CrcEngine *e, int d, BitReader *r, uint64_t frames, BitWriter *w,
+                                  const CrcSyndromes *fix, uint64_t *corrected, CrcFrameList *bad);
+
+static inline void crc_frame_list_add(CrcFrameList *list, uint64_t frame)
+{
+    if (list->count == list->cap) {
+        list->cap = list->cap ? list->cap * 2 : 64;
+        list->items = (uint64_t *)realloc(list->items, list->cap * sizeof(uint64_t));
+        if (!list->items) {
+            perror("memory allocation error");
+            exit(EXIT_FAILURE);
+        }
+    }
+    list->items[list->count++] = frame;
+}
+
+// D 비트 데이터워드(left-aligned)의 나머지: 0 상태에서 시작하므로 바이트마다 독립적인 테이블 조회
+template <int D>
+static inline uint64_t crc_word_remainder(const CrcEngine *e, uint64_t v)
+{
+    const int n = D / 8;
+    uint64_t crc = 0;
+    for (int k = 0; k < n; k++) { // 바이트 k 뒤에는 n - 1 - k 바이트가 더 옴
+        crc ^= e->table[n - 1 - k][(v >> (56 - 8 * k)) & 0xff];
+    }
+    if constexpr (D % 8 != 0) crc = crc_update_bits(e, crc, v << (8 * n), D % 8);
+    return crc;
+}
+
+// 바이트 경계에 맞춰 패킹된 입력에서 f 번째 D 비트 데이터워드 읽기
+template <int D>
+static inline uint64_t crc_word_at(const uint8_t *in, uint64_t f)
+{
+    if constexpr (D == 64) {
+        return load_be64(in + f * 8);
+    } else if constexpr (D == 32) {
+        uint32_t v;
+        memcpy(&v, in + f * 4, 4);
+        return (uint64_t)__builtin_bswap32(v) << 32;
+    } else if constexpr (D == 16) {
+        uint16_t v;
+        memcpy(&v, in + f * 2, 2);
+        return (uint64_t)__builtin_bswap16(v) << 48;
+    } else if constexpr (D == 8) {
+        return (uint64_t)in[f] << 56;
+    } else if constexpr (D == 4) {
+        return (uint64_t)((in[f >> 1] << (4 * (f & 1))) & 0xf0) << 56;
+    } else {
+        return load_bits(in, f * D, D);
+    }
+}
+
+// 특수화된 인코더: 좁은 생성기, D 비트 데이터워드
+// PACKED 이면 데이터워드와 나머지가 64비트에 함께 들어가 한 번에 출력
+template <int D, bool PACKED>
+static void crc_encode_frames(const CrcEngine *e, int d, const uint8_t *in, uint64_t frames, BitWriter *w)
+{
+    (void)d;
+    const int width = e->width;
+    const uint64_t mask = e->mask;
+    for (uint64_t f = 0; f < frames; f++) {
+        uint64_t v = crc_word_at<D>(in, f);
+        uint64_t rem = crc_word_remainder<D>(e, v) & mask;
+        if constexpr (PACKED && D == 64) {
+            put_bits(w, v, 64);
+        } else if constexpr (PACKED) {
+            put_bits(w, v | (rem >> D), D + width);
+        } else {
+            put_bits(w, v, D);
+            put_bits(w, rem, width);
+        }
+    }
+}
+
+// 특수화된 디코더: 좁은 생성기, D 비트 데이터워드
+template <int D, bool PACKED>
+static uint64_t crc_decode_frames(const CrcEngine *e, int d, BitReader *r, uint64_t frames, BitWriter *w,
+                                  const CrcSyndromes *fix, uint64_t *corrected, CrcFrameList *bad)
+{
+    (void)d;
+    const int width = e->width;
+    const uint64_t mask = e->mask;
+    uint64_t errors = 0;
+    for (uint64_t f = 0; f < frames; f++) {
+        uint64_t v, received;
+        if constexpr (PACKED && D == 64) { // 나머지 없음
+            v = get_bits(r, 64);
+            received = 0;
+        } else if constexpr (PACKED) {
+            uint64_t cw = get_bits(r, D + width);
+            v = cw & ~(~0ULL >> D);
+            received = cw << D;
+        } else {
+            v = get_bits(r, D);
+            received = get_bits(r, width);
+        }
+        uint64_t syndrome = (crc_word_remainder<D>(e, v) & mask) ^ received;
+        if (__builtin_expect(syndrome != 0, 0)) {
+            errors++;
+            int64_t bit = fix ? crc_syndrome_find(fix, syndrome, D + width) : -1;
+            if (bit >= 0) { // 나머지 부분의 오류면 데이터워드는 그대로
+                if (bit < D) v ^= 1ULL << (63 - bit);
+                (*corrected)++;
+            } else if (bad) {
+                crc_frame_list_add(bad, f);
+            }
+        }
+        put_bits(w, v, D);
+    }
+    return errors;
+}
+
+// pos 에서 시작하는 프레임(data_bits 비트 데이터워드 + 나머지)을 검사하고 데이터워드를 씀 (좁은 생성기)
+// 오류가 없으면 -1, 고친 비트 위치(프레임 앞에서부터)를 반환하고, 고칠 수 없으면 -2
+static inline int64_t crc_correct_frame(const CrcEngine *e, const CrcSyndromes *fix, const uint8_t *in, uint64_t pos,
+                                        uint64_t data_bits, BitWriter *w)
+{
+    uint64_t rem;
+    crc_engine_remainder(e, in, pos, data_bits, &rem);
+    uint64_t syndrome = rem ^ load_bits(in, pos + data_bits, e->width);
+    int64_t bit = syndrome ? crc_syndrome_find(fix, syndrome, data_bits + e->width) : -1;
+    if (bit < 0 || (uint64_t)bit >= data_bits) { // 데이터워드는 그대로
+        copy_bits(w, in, pos, data_bits);
+        return syndrome ? (bit >= 0 ? bit : -2) : -1;
+    }
+    copy_bits(w, in, pos, (uint64_t)bit);
+    put_bits(w, ~load_bits(in, pos + bit, 1) & (1ULL << 63), 1); // 틀린 비트를 뒤집어 씀
+    copy_bits(w, in, pos + bit + 1, data_bits - bit - 1);
+    return bit;
+}
+
+// 일반 인코더: 임의의 데이터워드 크기와 생성기
+static void crc_encode_frames_any(const CrcEngine *e, int d, const uint8_t *in, uint64_t frames, BitWriter *w)
+{
+    uint64_t rem[CRC_MAX_WORDS];
+    for (uint64_t f = 0, off = 0; f < frames; f++, off += d) {
+        crc_engine_remainder(e, in, off, d, rem); // 나머지 계산
+        copy_bits(w, in, off, d); // 데이터워드
+        int left = e->width;
+        for (int i = 0; left > 0; i++, left -= 64) { // 나머지
+            put_bits(w, rem[i], left < 64 ? left : 64);
+        }
+    }
+}
+
+// 일반 디코더: 임의의 데이터워드 크기와 생성기
+static uint64_t crc_decode_frames_any(const CrcEngine *e, int d, BitReader *r, uint64_t frames, BitWriter *w,
+                                      const CrcSyndromes *fix, uint64_t *corrected, CrcFrameList *bad)
+{
+    uint64_t errors = 0;
+    uint64_t pos = tell_bits(r);
+    for (uint64_t f = 0; f < frames; f++, pos += d + e->width) {
+        int failed;
+        if (fix) {
+            int64_t bit = crc_correct_frame(e, fix, r->data, pos, d, w);
+            errors += bit != -1;
+            *corrected += bit >= 0;
+            failed = bit == -2;
+        } else {
+            failed = crc_engine_check(e, r->data, pos, d);
+            errors += failed;
+            copy_bits(w, r->data, pos, d);
+        }
+        if (failed && bad) crc_frame_list_add(bad, f);
+    }
+    seek_bits(r, pos);
+    return errors;
+}
+
+#define CRC_SPECIALIZE(D)                                                                 \
+    case D:                                                                               \
+        if (D + e->width <= 64) {                                                         \
+            if (enc) *enc = crc_encode_frames<D, true>;                                   \
+            if (dec) *dec = crc_decode_frames<D, true>;                                   \
+        } else {                                                                          \
+            if (enc) *enc = crc_encode_frames<D, false>;                                  \
+            if (dec) *dec = crc_decode_frames<D, false>;                                  \
+        }                                                                                 \
+        return;
+
+// 생성기와 데이터워드 크기에 맞는 프레임 루프 선택
+static inline void crc_select_frames(const CrcEngine *e, int d, crc_encode_fn *enc, crc_decode_fn *dec)
+{
+    if (enc) *enc = crc_encode_frames_any;
+    if (dec) *dec = crc_decode_frames_any;
+    if (e->words != 1) return;
+    switch (d) {
+        CRC_SPECIALIZE(4)
+        CRC_SPECIALIZE(8)
+        CRC_SPECIALIZE(16)
+        CRC_SPECIALIZE(32)
+        CRC_SPECIALIZE(64)
+    }
+}
+
+#undef CRC_SPECIALIZE
+
+#endif
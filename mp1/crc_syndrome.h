@@ -0,0 +1,115 @@
+#ifndef CRC_SYNDROME_H
+#define CRC_SYNDROME_H
+
+#include "crc_engine.h"
+
+// 단일 비트 오류 정정용 신드롬 표 (crc_decoder -c)
+//
+// 길이 n 인 프레임의 i 번째 비트(0부터)가 뒤집히면 신드롬(계산한 나머지 XOR 받은 나머지)은
+// x^(n-1-i) mod G 가 된다. 그래서 신드롬 -> 지수 k 표 하나로 n 이하의 모든 프레임 길이
+// (입력 끝의 잘린 프레임 포함)에서 위치 n-1-k 를 찾을 수 있다.
+// 모든 x^k (k < n) 가 0이 아니고 서로 다를 때만 정정이 가능하다.
+// 두 비트 이상 틀린 프레임이 우연히 어떤 단일 비트 신드롬과 같으면 잘못 정정될 수 있다.
+
+typedef struct {
+    const uint64_t *keys; // 신드롬 (left-aligned, 0 은 빈 칸)
+    const uint32_t *exps; // 신드롬에 해당하는 지수 k
+    uint64_t slots;       // 표 크기 (2의 거듭제곱)
+    int shift;            // 해시 시프트 (64 - log2(slots))
+    uint64_t max_bits;    // 표가 다루는 최대 프레임 비트 수
+    void *owned;          // 직접 만든 표 메모리 (캐시에서 매핑했으면 NULL)
+    void *map;            // 캐시 파일 매핑 (crc_table_cache.h)
+    size_t map_len;
+} CrcSyndromes;
+
+static inline uint64_t crc_syndrome_slot(const CrcSyndromes *t, uint64_t s)
+{
+    return (s * 0x9E3779B97F4A7C15ULL) >> t->shift;
+}
+
+// 신드롬 s 에 해당하는 단일 비트 오류 위치 (프레임 앞에서부터), 없으면 -1
+static inline int64_t crc_syndrome_find(const CrcSyndromes *t, uint64_t s, uint64_t frame_bits)
+{
+    for (uint64_t i = crc_syndrome_slot(t, s);; i = (i + 1) & (t->slots - 1)) {
+        if (t->keys[i] == s) {
+            uint64_t k = t->exps[i];
+            return k < frame_bits ? (int64_t)(frame_bits - 1 - k) : -1;
+        }
+        if (t->keys[i] == 0) return -1;
+    }
+}
+
+static inline void crc_syndrome_free(CrcSyndromes *t)
+{
+    free(t->owned);
+    if (t->map) munmap(t->map, t->map_len);
+    t->owned = NULL;
+    t->map = NULL;
+    t->keys = NULL;
+    t->exps = NULL;
+}
+
+// 표 크기만 정함, 좁은 생성기(width <= 64)가 아니면 -1 반환
+static inline int crc_syndrome_setup(CrcSyndromes *t, const CrcEngine *e, uint64_t frame_bits)
+{
+    memset(t, 0, sizeof(*t));
+    if (e->words != 1 || e->width == 0 || frame_bits == 0 || frame_bits > UINT32_MAX) return -1;
+    int bits = 1;
+    while ((1ULL << bits) < 2 * frame_bits) bits++; // 채움률 1/2 이하
+    t->slots = 1ULL << bits;
+    t->shift = 64 - bits;
+    t->max_bits = frame_bits;
+    return 0;
+}
+
+// 표 메모리 크기 (keys 다음에 exps)
+static inline size_t crc_syndrome_bytes(const CrcSyndromes *t)
+{
+    return t->slots * (sizeof(uint64_t) + sizeof(uint32_t));
+}
+
+static inline void crc_syndrome_attach(CrcSyndromes *t, const void *mem)
+{
+    t->keys = (const uint64_t *)mem;
+    t->exps = (const uint32_t *)(t->keys + t->slots);
+}
+
+// crc_syndrome_setup 이 끝난 표를 mem 에 계산
+// 정정할 수 없는 조합(신드롬이 0 이거나 겹침)이면 -1 반환
+static inline int crc_syndrome_fill(const CrcSyndromes *t, const CrcEngine *e, void *mem)
+{
+    uint64_t *keys = (uint64_t *)mem;
+    uint32_t *exps = (uint32_t *)(keys + t->slots);
+    memset(keys, 0, t->slots * sizeof(uint64_t));
+
+    uint64_t s = 1ULL << (64 - e->width); // x^0: 마지막 비트
+    for (uint64_t k = 0; k < t->max_bits; k++) {
+        uint64_t i = crc_syndrome_slot(t, s);
+        while (s != 0 && keys[i] != 0 && keys[i] != s) i = (i + 1) & (t->slots - 1);
+        if (s == 0 || keys[i] == s) return -1; // 신드롬이 0 이거나 두 위치의 신드롬이 같음
+        keys[i] = s;
+        exps[i] = (uint32_t)k;
+        s = crc_step_bit(s, e->poly) & e->mask; // x 를 곱함
+    }
+    return 0;
+}
+
+// 좁은 생성기(width <= 64)로 frame_bits 비트 이하 프레임의 신드롬 표 생성
+// 정정할 수 없는 조합이면 -1 반환
+static inline int crc_syndrome_init(CrcSyndromes *t, const CrcEngine *e, uint64_t frame_bits)
+{
+    if (crc_syndrome_setup(t, e, frame_bits) != 0) return -1;
+    t->owned = malloc(crc_syndrome_bytes(t));
+    if (!t->owned) {
+        perror("memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    if (crc_syndrome_fill(t, e, t->owned) != 0) {
+        crc_syndrome_free(t);
+        return -1;
+    }
+    crc_syndrome_attach(t, t->owned);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef CRC_TABLE_CACHE_H
+#define CRC_TABLE_CACHE_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "crc_engine.h"
+#include "crc_syndrome.h"
+
+// 생성기 테이블 디스크 캐시 (crc_encoder / crc_decoder 시작 시간 단축)
+//
+// 슬라이싱 테이블과 신드롬 표를 파일로 저장해 두고 다음 실행부터 mmap 으로 바로 쓴다.
+// 여러 프로세스가 같은 생성기를 쓰면 페이지 캐시의 같은 페이지를 공유한다.
+// 파일: 헤더 | 생성기 문자열 | (64바이트 정렬) 테이블. 헤더에 버전, 종류, 바이트 순서,
+// 추가 키(신드롬 표는 프레임 비트 수)와 체크섬이 있어 하나라도 맞지 않으면 새로 만든다.
+// 저장은 임시 파일에 쓴 뒤 rename 하므로 동시에 실행해도 깨진 파일을 읽지 않는다.
+// 위치는 CRC_TABLE_CACHE (디렉터리, "off" 또는 빈 문자열이면 캐시 안 씀),
+// 없으면 $HOME/.cache/crc_tables. 캐시 관련 실패는 모두 무시하고 직접 계산한다.
+
+#define CRC_CACHE_MAGIC "CRCTBL\0"
+#define CRC_CACHE_VERSION 1
+#define CRC_CACHE_ENDIAN 0x0102030405060708ULL
+#define CRC_CACHE_ALIGN 64
+
+enum { CRC_CACHE_ENGINE = 1, CRC_CACHE_SYNDROME = 2 };
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;        // CRC_CACHE_ENGINE / CRC_CACHE_SYNDROME
+    uint64_t endian;      // CRC_CACHE_ENDIAN (다른 바이트 순서에서 만든 파일 거부)
+    uint64_t param;       // 종류별 추가 키
+    uint32_t key_len;     // 생성기 문자열 길이
+    uint32_t data_offset; // 파일 앞에서 테이블까지 바이트 수
+    uint64_t data_len;
+    uint64_t checksum;    // 생성기 문자열과 테이블의 crc_cache_hash
+} CrcCacheHeader;
+
+static inline uint64_t crc_cache_hash(uint64_t h, const void *p, size_t n)
+{
+    const uint8_t *b = (const uint8_t *)p;
+    for (; n >= 8; n -= 8, b += 8) { // 워드 단위 FNV-1a
+        uint64_t v;
+        memcpy(&v, b, 8);
+        h = (h ^ v) * 0x100000001B3ULL;
+    }
+    for (; n > 0; n--, b++) h = (h ^ *b) * 0x100000001B3ULL;
+    return h;
+}
+
+// 캐시 디렉터리, 캐시를 쓰지 않으면 -1
+static inline int crc_cache_dir(char *dir, size_t size)
+{
+    const char *env = getenv("CRC_TABLE_CACHE");
+    int n;
+    if (env) {
+        if (env[0] == '\0' || strcmp(env, "off") == 0) return -1;
+        n = snprintf(dir, size, "%s", env);
+    } else {
+        const char *home = getenv("HOME");
+        if (!home || home[0] == '\0') return -1;
+        n = snprintf(dir, size, "%s/.cache/crc_tables", home);
+    }
+    return n > 0 && (size_t)n < size ? 0 : -1;
+}
+
+// kind, 생성기, param 으로 정한 캐시 파일 경로
+static inline int crc_cache_path(char *path, size_t size, int kind, const char *generator, uint64_t param)
+{
+    char dir[PATH_MAX];
+    if (crc_cache_dir(dir, sizeof(dir)) != 0) return -1;
+    uint64_t h = crc_cache_hash(0xCBF29CE484222325ULL, generator, strlen(generator));
+    int n = snprintf(path, size, "%s/%s-%d-%016llx-%llu.tbl", dir, kind == CRC_CACHE_ENGINE ? "engine" : "syndrome",
+                     (int)strlen(generator) - 1, (unsigned long long)h, (unsigned long long)param);
+    return n > 0 && (size_t)n < size ? 0 : -1;
+}
+
+// 캐시 파일을 매핑하고 테이블 위치 반환, 없거나 맞지 않으면 NULL
+static inline const void *crc_cache_load(int kind, const char *generator, uint64_t param, size_t data_len, void **map,
+                                         size_t *map_len)
+{
+    char path[PATH_MAX];
+    if (crc_cache_path(path, sizeof(path), kind, generator, param) != 0) return NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CrcCacheHeader)) {
+        close(fd);
+        return NULL;
+    }
+    size_t len = (size_t)st.st_size;
+    void *m = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED) return NULL;
+
+    const CrcCacheHeader *h = (const CrcCacheHeader *)m;
+    size_t key_len = strlen(generator);
+    const uint8_t *base = (const uint8_t *)m;
+    int ok = memcmp(h->magic, CRC_CACHE_MAGIC, 8) == 0 && h->version == CRC_CACHE_VERSION && h->kind == (uint32_t)kind &&
+             h->endian == CRC_CACHE_ENDIAN && h->param == param && h->key_len == key_len && h->data_len == data_len &&
+             h->data_offset % CRC_CACHE_ALIGN == 0 && h->data_offset >= sizeof(*h) + key_len &&
+             (uint64_t)h->data_offset + data_len == len && memcmp(base + sizeof(*h), generator, key_len) == 0;
+    if (ok) {
+        uint64_t sum = crc_cache_hash(0xCBF29CE484222325ULL, generator, key_len);
+        ok = crc_cache_hash(sum, base + h->data_offset, data_len) == h->checksum;
+    }
+    if (!ok) {
+        munmap(m, len);
+        return NULL;
+    }
+    *map = m;
+    *map_len = len;
+    return base + h->data_offset;
+}
+
+static inline int crc_cache_write_all(int fd, const void *p, size_t n)
+{
+    const uint8_t *b = (const uint8_t *)p;
+    while (n > 0) {
+        ssize_t w = write(fd, b, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return -1;
+        b += w;
+        n -= (size_t)w;
+    }
+    return 0;
+}
+
+// 테이블을 캐시 파일로 저장 (임시 파일에 쓰고 rename), 실패해도 조용히 넘어감
+static inline void crc_cache_store(int kind, const char *generator, uint64_t param, const void *data, size_t data_len)
+{
+    char dir[PATH_MAX], path[PATH_MAX], tmp[PATH_MAX + 32];
+    if (crc_cache_dir(dir, sizeof(dir)) != 0) return;
+    if (crc_cache_path(path, sizeof(path), kind, generator, param) != 0) return;
+    if (!getenv("CRC_TABLE_CACHE")) { // 기본 위치면 ~/.cache 부터 만듦
+        char parent[PATH_MAX];
+        snprintf(parent, sizeof(parent), "%s/.cache", getenv("HOME"));
+        mkdir(parent, 0755);
+    }
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) return;
+    snprintf(tmp, sizeof(tmp), "%s.%d.tmp", path, (int)getpid());
+
+    size_t key_len = strlen(generator);
+    CrcCacheHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CRC_CACHE_MAGIC, 8);
+    h.version = CRC_CACHE_VERSION;
+    h.kind = (uint32_t)kind;
+    h.endian = CRC_CACHE_ENDIAN;
+    h.param = param;
+    h.key_len = (uint32_t)key_len;
+    h.data_offset = (uint32_t)((sizeof(h) + key_len + CRC_CACHE_ALIGN - 1) / CRC_CACHE_ALIGN * CRC_CACHE_ALIGN);
+    h.data_len = data_len;
+    h.checksum = crc_cache_hash(crc_cache_hash(0xCBF29CE484222325ULL, generator, key_len), data, data_len);
+
+    static const uint8_t zeros[CRC_CACHE_ALIGN] = {0};
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+    int ok = crc_cache_write_all(fd, &h, sizeof(h)) == 0 && crc_cache_write_all(fd, generator, key_len) == 0 &&
+             crc_cache_write_all(fd, zeros, h.data_offset - sizeof(h) - key_len) == 0 &&
+             crc_cache_write_all(fd, data, data_len) == 0;
+    if (close(fd) != 0) ok = 0;
+    if (!ok || rename(tmp, path) != 0) unlink(tmp);
+}
+
+// crc_engine_init 과 같지만 바이트 테이블을 캐시에서 읽거나, 새로 만들어 캐시에 저장
+static inline int crc_engine_init_cached(CrcEngine *e, const char *generator)
+{
+    if (crc_engine_setup(e, generator) != 0) return -1;
+    size_t len = crc_engine_table_words(e) * sizeof(uint64_t);
+    const void *tables = crc_cache_load(CRC_CACHE_ENGINE, generator, 0, len, &e->map, &e->map_len);
+    if (tables) {
+        crc_engine_attach(e, (const uint64_t *)tables);
+        return 0;
+    }
+    e->owned = (uint64_t *)malloc(len);
+    if (!e->owned) {
+        perror("memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    crc_engine_fill_tables(e, e->owned);
+    crc_engine_attach(e, e->owned);
+    crc_cache_store(CRC_CACHE_ENGINE, generator, 0, e->owned, len);
+    return 0;
+}
+
+// crc_syndrome_init 과 같지만 신드롬 표를 캐시에서 읽거나, 새로 만들어 캐시에 저장
+// 정정할 수 없는 조합은 저장하지 않으므로 매번 다시 확인한다
+static inline int crc_syndrome_init_cached(CrcSyndromes *t, const CrcEngine *e, const char *generator,
+                                           uint64_t frame_bits)
+{
+    if (crc_syndrome_setup(t, e, frame_bits) != 0) return -1;
+    size_t len = crc_syndrome_bytes(t);
+    const void *mem = crc_cache_load(CRC_CACHE_SYNDROME, generator, frame_bits, len, &t->map, &t->map_len);
+    if (mem) {
+        crc_syndrome_attach(t, mem);
+        return 0;
+    }
+    if (crc_syndrome_init(t, e, frame_bits) != 0) return -1;
+    crc_cache_store(CRC_CACHE_SYNDROME, generator, frame_bits, t->owned, len);
+    return 0;
+}
+
+#endif
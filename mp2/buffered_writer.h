@@ -0,0 +1,105 @@
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 늘어나는 바이트 버퍼와 큰 버퍼를 쓰는 출력 (linkstate / distvec 공용)
+//
+// 출력을 한 줄씩 fprintf 하지 않고 메모리에 모았다가 WRITER_FLUSH_SIZE 를 넘으면 fwrite 한 번으로 내보낸다.
+// 정수는 snprintf 없이 직접 10 진수로 바꾼다.
+// 같은 파일에 다른 함수가 stdio 로 직접 쓰기 전에는 writer_flush 로 모은 내용을 먼저 내보내야 한다.
+
+#define WRITER_FLUSH_SIZE (4 << 20) // 모은 출력이 이보다 크면 파일로 내보냄
+
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+} ByteBuffer;
+
+// extra 바이트를 더 쓸 공간 확보
+static inline void byte_buffer_reserve(ByteBuffer *buffer, size_t extra)
+{
+    if (buffer->length + extra <= buffer->capacity) return;
+    size_t capacity = buffer->capacity ? buffer->capacity : 256;
+    while (capacity < buffer->length + extra) capacity *= 2;
+    buffer->data = (char *)realloc(buffer->data, capacity);
+    if (buffer->data == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    buffer->capacity = capacity;
+}
+
+static inline void byte_buffer_put(ByteBuffer *buffer, const char *text, size_t length)
+{
+    byte_buffer_reserve(buffer, length);
+    memcpy(buffer->data + buffer->length, text, length);
+    buffer->length += length;
+}
+
+static inline void byte_buffer_put_char(ByteBuffer *buffer, char c)
+{
+    byte_buffer_reserve(buffer, 1);
+    buffer->data[buffer->length++] = c;
+}
+
+// 10 진수 정수 (printf 의 %d 와 같음)
+static inline void byte_buffer_put_int(ByteBuffer *buffer, int value)
+{
+    char digits[12];
+    int count = 0;
+    unsigned magnitude = value < 0 ? 0u - (unsigned)value : (unsigned)value;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    byte_buffer_reserve(buffer, count + 1);
+    if (value < 0) buffer->data[buffer->length++] = '-';
+    while (count > 0) buffer->data[buffer->length++] = digits[--count];
+}
+
+static inline void byte_buffer_free(ByteBuffer *buffer)
+{
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->length = buffer->capacity = 0;
+}
+
+typedef struct {
+    FILE *file;
+    ByteBuffer buffer;
+} BufferedWriter;
+
+static inline void writer_init(BufferedWriter *writer, FILE *file)
+{
+    writer->file = file;
+    writer->buffer.data = NULL;
+    writer->buffer.length = writer->buffer.capacity = 0;
+    byte_buffer_reserve(&writer->buffer, WRITER_FLUSH_SIZE);
+}
+
+static inline void writer_flush(BufferedWriter *writer)
+{
+    if (writer->buffer.length > 0 && fwrite(writer->buffer.data, 1, writer->buffer.length, writer->file) != writer->buffer.length) {
+        printf("Error: write output file.\n");
+        exit(1);
+    }
+    writer->buffer.length = 0;
+}
+
+// 버퍼에 쓴 뒤 호출: 모은 출력이 충분히 크면 내보냄
+static inline void writer_maybe_flush(BufferedWriter *writer)
+{
+    if (writer->buffer.length >= WRITER_FLUSH_SIZE) writer_flush(writer);
+}
+
+static inline void writer_free(BufferedWriter *writer)
+{
+    writer_flush(writer);
+    byte_buffer_free(&writer->buffer);
+}
+
+#endif
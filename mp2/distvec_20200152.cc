@@ -1,11 +1,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "routing_store.h"
+#include "minplus.h"
+#include "mailbox.h"
+#include "message_batch.h"
+#include "fib_snapshot.h"
+#include "steal_pool.h"
 
-#define MAX_NODES 100 // 최대 노드 수를 정의
 #define NOT_EXIST -1 // 존재하지 않음을 나타내는 상수
 #define INFINITY_COST 999 // 무한 비용을 나타내는 상수
-#define MAX_MESSAGE_LENGTH 1000 // 최대 메시지 길이를 정의
+#define ROW_BLOCK 8 // 모든 칸 라운드에서 열 하나를 같이 쓰는 출발 노드 수
+#define DV_TILE 64 // -j: 라운드를 나눠 계산하는 정사각 타일 한 변의 노드 수 (ROW_BLOCK 의 배수)
+#define MAILBOX_SIZE 4096 // 스레드 쌍마다의 우편함 크기 (바뀐 칸 알림 수)
+#define WORK_BATCH 1024 // 우편함을 다시 보기 전에 처리할 칸 수
 
 typedef struct {
     int source; // 링크의 출발 노드
@@ -13,38 +26,121 @@ typedef struct {
     int cost; // 링크의 비용
 } Link;
 
-typedef struct {
-    int previous; // 이전 노드 (미사용)
-    int next_hop; // 다음 홉
-    int cost; // 비용
-} Route;
-
 FILE *topology_file; // 토폴로지 파일 포인터
 FILE *message_file; // 메시지 파일 포인터
 FILE *change_file; // 변경 파일 포인터
 FILE *output_file; // 출력 파일 포인터
+MessageBatch messages; // 메시지 파일 내용 (처음에 한 번만 읽음)
+BufferedWriter writer; // output_file 출력 버퍼 (라우팅 테이블, 메시지)
+int snapshot_file = -1; // -b: 라우팅 테이블을 텍스트 대신 쓸 바이너리 스냅숏 파일 (없으면 -1)
+uint32_t snapshot_sequence; // 다음에 쓸 스냅숏 번호
 
-Link link_table[MAX_NODES]; // 링크 정보를 저장할 테이블
+Link *link_table; // 링크 정보를 저장할 테이블
 int link_count = 0; // 링크 개수
+int link_capacity = 0; // 링크 테이블 크기
 int node_count; // 노드 개수
 
-Route routing_table[MAX_NODES][MAX_NODES]; // 라우팅 테이블
+RoutingStore routing_table; // 라우팅 테이블 (비용, 다음 홉)
 
 int has_changes; // 변화가 있었는지 여부를 나타내는 플래그
 
+// 라운드 동안 값이 바뀐 라우팅 테이블 칸 목록 (행 i 의 바뀐 열, 열 j 의 바뀐 행)
+typedef struct {
+    int *items;
+    int count;
+    int capacity;
+} IndexList;
+
+typedef struct {
+    IndexList *row_prev, *row_cur; // 행별: 지난 라운드 / 이번 라운드에 바뀐 열
+    IndexList *col_prev, *col_cur; // 열별: 지난 라운드 / 이번 라운드에 바뀐 행
+    int full; // 다음 라운드는 모든 칸을 계산 (라우팅 테이블을 새로 초기화한 뒤)
+    long long last_writes; // 지난 라운드에 바뀐 칸 수
+} DvWorklist;
+
+DvWorklist worklist; // 바뀐 칸 작업 목록
+
+// 모든 칸 라운드용 비용 전치 복사본: cost_column[j * node_count + k] == (k, j) 의 비용
+// 수렴을 시작할 때 한 번 만들고 모든 칸 라운드가 칸을 바꿀 때 같이 바꾼다. 작업 목록 라운드는 바꾸지 않고
+// 무효로 표시하므로, 그 뒤에 다시 모든 칸 라운드를 할 때만 (드묾) 새로 만든다.
+void *cost_column;
+size_t cost_column_bytes; // 할당한 크기
+int cost_column_valid; // 지금 라우팅 테이블과 같은지 (initialize_routing_table 이 0 으로 만듦)
+
+#define ADVERTISE_ALL 0 // 모든 경로를 이웃에게 알림
+#define ADVERTISE_SPLIT_HORIZON 1 // 이웃을 거치는 경로는 그 이웃에게 알리지 않음
+#define ADVERTISE_POISON_REVERSE 2 // 이웃을 거치는 경로는 그 이웃에게 INFINITY_COST 로 알림
+
+int warm_start; // -w: 링크가 바뀌면 이전 테이블에서 다시 수렴
+int advertise_mode = ADVERTISE_ALL; // -s / -p: 다시 수렴할 때 이웃에게 알리는 방식
+
+// 다시 수렴할 때 쓰는 이웃 목록 (CSR): 노드 i 의 이웃은 neighbor_node[neighbor_start[i] .. neighbor_start[i + 1])
+int *neighbor_start;
+int *neighbor_node;
+int *neighbor_cost;
+
+int dv_threads; // -j: 스레드 수 (라운드는 타일로 나눠 계산, -w 는 노드를 나눠 비동기로 다시 수렴, 0 이면 한 스레드)
+
+// 스레드 하나가 맡은 노드 구간 [begin, end) 의 비동기 계산 상태
+typedef struct {
+    int id;
+    int begin, end;
+    char *pending; // (i - begin) * node_count + j : (i, j) 칸이 작업 큐에 있는지
+    long long *queue; // 다시 계산할 칸 (i * node_count + j), [queue_head, queue_count) 가 남은 칸
+    long long queue_head, queue_count, queue_capacity;
+    uint64_t **outbox; // 스레드별 아직 우편함에 넣지 못한 알림
+    int *outbox_count, *outbox_capacity;
+    int *sent_stamp; // 알림 하나를 스레드마다 한 번만 보내도록 표시
+    int stamp;
+    int busy; // outstanding 에 이 스레드의 몫이 들어 있는지
+    long long updates; // 바꾼 칸 수
+    char pad[64];
+} DvPartition;
+
+DvPartition *partitions;
+int *node_partition; // 노드를 맡은 스레드
+int table_canonical; // 라우팅 테이블이 다시 수렴이 끝난 상태인지 (아니면 모든 노드부터 다시 계산)
+Mailbox *mailboxes; // mailboxes[from * dv_threads + to]
+long long outstanding; // 일하는 스레드 수 + 아직 받지 않은 알림 수 (0 이면 끝)
+
 // 함수 선언
 int initialize(int argc, char **argv);
 void print_routing_table();
 void distance_vector();
+void reset_worklist();
+void free_worklist();
 void initialize_routing_table();
+void add_link(int source, int destination, int cost);
 void read_topology();
 void process_messages();
 void update_link_cost(int source, int destination, int new_cost);
 void apply_changes();
+int build_neighbors();
+void reconverge(int a, int b);
+long long parallel_converge(const int *seeds, int seed_count);
+void converge_from_scratch();
 
 int initialize(int argc, char **argv) {
-    if (argc != 4) { // 인자 개수가 올바른지 확인
-        printf("usage: distvec topologyfile messagesfile changesfile\n");
+    int opt;
+    int usage = 0;
+    int binary = 0; // -b: 라우팅 테이블을 output_dv.fib 에 바이너리 스냅숏으로 씀
+    while ((opt = getopt(argc, argv, "wspj:b")) != -1) {
+        if (opt == 'j' && atoi(optarg) > 0) {
+            dv_threads = atoi(optarg);
+        } else if (opt == 'b') {
+            binary = 1;
+        } else if (opt == 'w') {
+            warm_start = 1;
+        } else if ((opt == 's' || opt == 'p') && advertise_mode == ADVERTISE_ALL) {
+            advertise_mode = opt == 's' ? ADVERTISE_SPLIT_HORIZON : ADVERTISE_POISON_REVERSE;
+        } else {
+            usage = 1; // 모르는 옵션, -s 와 -p 를 같이 씀, 잘못된 스레드 수
+        }
+    }
+    argc -= optind - 1; // 옵션을 건너뛴 파일 인자
+    argv += optind - 1;
+    if (usage || argc != 4 || (advertise_mode != ADVERTISE_ALL && !warm_start)) { // 인자 개수가 올바른지 확인
+        printf("usage: distvec [-w [-s | -p]] [-j threads] [-b] topologyfile messagesfile changesfile\n");
         return -1;
     }
 
@@ -72,55 +168,282 @@ int initialize(int argc, char **argv) {
         return -1;
     }
 
+    if (binary) {
+        snapshot_file = open("output_dv.fib", O_WRONLY | O_CREAT | O_TRUNC, 0644); // 스냅숏 파일 열기
+        if (snapshot_file < 0) {
+            printf("Error: open output file output_dv.fib.\n");
+            return -1;
+        }
+    }
+
     return 0; // 초기화 성공
 }
 
 void print_routing_table() {
-    char buffer[1024]; // 출력 버퍼
-    for (int i = 0; i < node_count; i++) { // 모든 노드에 대해
-        int offset = 0; // 버퍼 오프셋
-        for (int j = 0; j < node_count; j++) { // 모든 목적지에 대해
-            if (routing_table[i][j].cost != INFINITY_COST) { // 유효한 경로인지 확인
-                offset += snprintf(buffer + offset, sizeof(buffer) - offset, "%d %d %d\n", j, routing_table[i][j].next_hop, routing_table[i][j].cost); // 버퍼에 경로 저장
+    if (snapshot_file >= 0) { // -b: 텍스트는 fibdump 로 스냅숏에서 만듦
+        fib_snapshot_write(snapshot_file, &routing_table, snapshot_sequence++, INFINITY_COST);
+        return;
+    }
+    routing_store_write_text(&routing_table, &writer, INFINITY_COST);
+}
+
+static void index_list_push(IndexList *list, int value) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 16;
+        list->items = (int *)realloc(list->items, sizeof(int) * list->capacity);
+        if (list->items == NULL) {
+            printf("Error: out of memory.\n");
+            exit(1);
+        }
+    }
+    list->items[list->count++] = value;
+}
+
+// (i, j) 칸이 이번 라운드에 바뀌었음을 기록
+static inline void mark_changed(int i, int j) {
+    index_list_push(&worklist.row_cur[i], j);
+    index_list_push(&worklist.col_cur[j], i);
+}
+
+// 라운드 시작: 이번 라운드 목록을 지난 라운드 목록으로 넘기고 비움
+static void begin_round() {
+    IndexList *t = worklist.row_prev;
+    worklist.row_prev = worklist.row_cur;
+    worklist.row_cur = t;
+    t = worklist.col_prev;
+    worklist.col_prev = worklist.col_cur;
+    worklist.col_cur = t;
+    for (int i = 0; i < node_count; i++) {
+        worklist.row_cur[i].count = 0;
+        worklist.col_cur[i].count = 0;
+    }
+}
+
+// 모든 칸을 계산하는 라운드: 저장 폭(C: 비용, H: 다음 홉)에 맞게 특수화, 값을 바꾼 칸이 있으면 1 반환
+//
+// (i, j) 마다 min_k (i, k) + (k, j) 를 구하고 지금 비용보다 작을 때만 칸을 바꾼다.
+// 그때 다음 홉은 최소 비용을 내는 가장 작은 k 의 홉과, k != i 인 홉 중 가장 작은 값 가운데 작은 쪽이다.
+// 열 j 를 연속으로 읽도록 비용을 전치한 복사본 (cost_column) 을 쓰고 (칸을 바꾸면 같이 바꿈), min-plus 커널로 계산한다.
+// 출발 노드 ROW_BLOCK 개씩 묶어 열 하나를 캐시에 올린 채 묶음의 모든 행을 계산한다 (j 바깥, i 안쪽).
+// (i, j) 는 행 i 와 열 j 만 읽는다. 행 i 의 앞쪽 칸과 열 j 의 위쪽 칸은 이미 계산되어 있고 나머지는 아직이므로,
+// 행 하나씩 차례로 계산하는 순서와 읽는 값이 같아 결과도 같다.
+// 출발 노드 [row_begin, row_end) 와 목적지 [col_begin, col_end) 의 칸만 계산한다 (-j 의 타일, 아니면 테이블 전체).
+template <typename C, typename H>
+static int distance_vector_round(RoutingStore *store, int row_begin, int row_end, int col_begin, int col_end) {
+    int changed = 0;
+    int n = node_count;
+    C *cost = (C *)store->cost;
+    H *next = (H *)store->next_hop;
+    C *column = (C *)cost_column;
+
+    for (int block = row_begin; block < row_end; block += ROW_BLOCK) {
+        int block_end = block + ROW_BLOCK < row_end ? block + ROW_BLOCK : row_end;
+        for (int j = col_begin; j < col_end; j++) { // 목적지 노드에 대해
+            const C *column_j = column + (size_t)j * n;
+            for (int i = block; i < block_end; i++) { // 묶음의 출발 노드에 대해
+                C *row_cost = cost + (size_t)i * n; // 출발 노드의 행
+                H *row_next = next + (size_t)i * n;
+                int best_cost = minplus_min(row_cost, column_j, n);
+                if (best_cost >= row_cost[j]) continue; // 더 짧은 경로 없음
+
+                int first = minplus_find(row_cost, column_j, n, 0, best_cost);
+                int best_next_hop = row_next[first];
+                for (int k = first; k < n; k = minplus_find(row_cost, column_j, n, k + 1, best_cost)) {
+                    if (k != i && row_next[k] < best_next_hop) best_next_hop = row_next[k]; // 더 작은 홉 값을 선택
+                }
+                row_cost[j] = (C)best_cost; // 비용 업데이트
+                row_next[j] = (H)best_next_hop; // 다음 홉 업데이트
+                column[(size_t)j * n + i] = (C)best_cost;
+                mark_changed(i, j);
+                changed = 1;
             }
         }
-        snprintf(buffer + offset, sizeof(buffer) - offset, "\n"); // 버퍼에 빈 줄 삽입
-        fputs(buffer, output_file); // 한 번에 출력
     }
+    return changed;
 }
 
-void distance_vector() {
-    has_changes = 0; // 변화 플래그 초기화
-    for (int i = 0; i < node_count; i++) { // 모든 출발 노드에 대해
-        for (int j = 0; j < node_count; j++) { // 모든 목적지 노드에 대해
-            int current_cost = routing_table[i][j].cost;
+// 작업 목록 라운드: 바뀐 칸을 거치는 경로만 다시 계산, 값을 바꾼 칸이 있으면 1 반환
+//
+// (i, j) 는 k 를 거치는 경로 비용 (i, k) + (k, j) 를 본다. 지난번 (i, j) 를 계산한 뒤로
+// 두 칸이 모두 그대로인 k 는 그때 이미 본 값이므로 지금 비용보다 작을 수 없다.
+// 따라서 지난 라운드와 이번 라운드에 바뀐 행 i 의 칸과 열 j 의 칸만 후보로 보면 된다.
+// 모든 칸 라운드는 비용이 줄 때만 칸을 바꾼다. 그때 다음 홉은 최소 비용을 내는 k 중
+// 가장 작은 k 의 홉과, k != i 인 홉 중 가장 작은 값 가운데 작은 쪽이다.
+// 이 값은 k 를 보는 순서와 무관해 후보를 목록 순서대로 봐도 결과가 같다.
+// 비용이 같아 다음 홉만 바뀔 수 있는 경우는 모든 칸 라운드도 칸을 바꾸지 않는다.
+// 그래서 값을 바꾼 칸이 없는 라운드에서 멈춰도 출력은 같다. 계산하는 칸의 범위는 모든 칸 라운드와 같다.
+template <typename C, typename H>
+static int distance_vector_worklist_round(RoutingStore *store, int row_begin, int row_end, int col_begin, int col_end) {
+    int changed = 0;
+    int n = node_count;
+    C *cost = (C *)store->cost;
+    H *next = (H *)store->next_hop;
+    for (int i = row_begin; i < row_end; i++) {
+        C *row_cost = cost + (size_t)i * n;
+        H *row_next = next + (size_t)i * n;
+        IndexList *row_prev = &worklist.row_prev[i];
+        IndexList *row_cur = &worklist.row_cur[i];
+        for (int j = col_begin; j < col_end; j++) {
+            IndexList *lists[4] = {row_prev, row_cur, &worklist.col_prev[j], &worklist.col_cur[j]};
+            if (lists[0]->count + lists[1]->count + lists[2]->count + lists[3]->count == 0) continue; // 후보 없음
+
+            int current_cost = row_cost[j];
             int best_cost = current_cost;
-            int best_next_hop = routing_table[i][j].next_hop;
-            for (int k = 0; k < node_count; k++) { // 모든 노드에 대해
-                int new_cost = routing_table[i][k].cost + routing_table[k][j].cost;
-                if (new_cost < best_cost) { // 더 짧은 경로를 찾으면
-                    best_cost = new_cost;
-                    best_next_hop = routing_table[i][k].next_hop;
-                    has_changes = 1; // 변화 플래그 설정
-                } else if (new_cost == best_cost && routing_table[i][k].next_hop < best_next_hop && i != k) { // 비용이 같은 경로가 있으면
-                    best_next_hop = routing_table[i][k].next_hop; // 더 작은 홉 값을 선택
-                    has_changes = 1; // 변화 플래그 설정
+            int first = -1; // 최소 비용을 내는 가장 작은 k
+            int best_next_hop = INT_MAX; // 최소 비용을 내는 k (k != i) 의 가장 작은 홉
+            for (int l = 0; l < 4; l++) {
+                for (int c = 0; c < lists[l]->count; c++) {
+                    int k = lists[l]->items[c]; // 행 목록은 (i, k), 열 목록은 (k, j) 가 바뀐 k
+                    int new_cost = row_cost[k] + cost[(size_t)k * n + j];
+                    if (new_cost < best_cost) {
+                        best_cost = new_cost;
+                        first = k;
+                        best_next_hop = k != i ? (int)row_next[k] : INT_MAX;
+                    } else if (new_cost == best_cost && first >= 0) {
+                        if (k < first) first = k;
+                        if (k != i && row_next[k] < best_next_hop) best_next_hop = row_next[k];
+                    }
                 }
             }
-            if (best_cost != current_cost) {
-                routing_table[i][j].cost = best_cost; // 비용 업데이트
-                routing_table[i][j].next_hop = best_next_hop; // 다음 홉 업데이트
+            if (first >= 0) {
+                int next_hop = row_next[first] < best_next_hop ? (int)row_next[first] : best_next_hop;
+                row_cost[j] = (C)best_cost;
+                row_next[j] = (H)next_hop;
+                mark_changed(i, j);
+                changed = 1;
             }
         }
     }
+    return changed;
+}
+
+// 비용 전치 복사본을 지금 테이블로 만듦 (수렴마다 한 번)
+template <typename C, typename H>
+static int build_cost_column(RoutingStore *store) {
+    int n = node_count;
+    size_t bytes = sizeof(C) * n * n + 1;
+    if (bytes > cost_column_bytes) {
+        free(cost_column);
+        cost_column = malloc(bytes);
+        if (cost_column == NULL) {
+            printf("Error: out of memory.\n");
+            exit(1);
+        }
+        cost_column_bytes = bytes;
+    }
+    const C *cost = (const C *)store->cost;
+    C *column = (C *)cost_column;
+    for (int k = 0; k < n; k++) {
+        for (int j = 0; j < n; j++) column[(size_t)j * n + k] = cost[(size_t)k * n + j];
+    }
+    cost_column_valid = 1;
+    return 0;
+}
+
+// -j 라운드: 테이블을 DV_TILE x DV_TILE 타일로 나누고, 타일 (I, J) 를 반대각선 I + J 순서로 계산한다.
+//
+// (i, j) 는 행 i 와 열 j 만 읽고 쓴다 (작업 목록의 row_cur[i], col_cur[j], 전치 복사본의 열 j 도 같음).
+// 같은 행 타일이나 같은 열 타일의 두 타일은 앞 번호 타일이 앞 반대각선에 있어 먼저 끝나므로,
+// 같은 행이나 같은 열의 두 칸은 한 스레드의 라운드와 같은 순서로 계산되고 읽는 값도 같다.
+// 같은 반대각선의 타일끼리는 행도 열도 겹치지 않아 스레드로 나눠 계산한다. 출력은 한 스레드와 같다.
+typedef struct {
+    int full; // 모든 칸 라운드인지 (아니면 작업 목록 라운드)
+    int tiles; // 한 변의 타일 수
+    int diagonal; // 계산할 반대각선 I + J
+    int changed; // 값을 바꾼 칸이 있었는지
+} WavefrontTask;
+
+// 반대각선의 index 번째 타일 계산 (steal_pool 작업)
+static void wavefront_tile(void *ctx, int worker, int index) {
+    WavefrontTask *task = (WavefrontTask *)ctx;
+    int row_tile = (task->diagonal < task->tiles ? 0 : task->diagonal - task->tiles + 1) + index;
+    int col_tile = task->diagonal - row_tile;
+    int row_begin = row_tile * DV_TILE, col_begin = col_tile * DV_TILE;
+    int row_end = row_begin + DV_TILE < node_count ? row_begin + DV_TILE : node_count;
+    int col_end = col_begin + DV_TILE < node_count ? col_begin + DV_TILE : node_count;
+    int changed = task->full
+        ? ROUTING_STORE_DISPATCH(&routing_table, distance_vector_round, &routing_table, row_begin, row_end, col_begin, col_end)
+        : ROUTING_STORE_DISPATCH(&routing_table, distance_vector_worklist_round, &routing_table, row_begin, row_end, col_begin, col_end);
+    if (changed) __atomic_store_n(&task->changed, 1, __ATOMIC_RELAXED);
+    (void)worker;
+}
+
+// 라운드 하나를 계산하고 값을 바꾼 칸이 있으면 1 반환 (-j 면 타일 반대각선마다 스레드로 나눔)
+static int run_round(int full) {
+    int n = node_count;
+    if (dv_threads <= 1 || n <= DV_TILE) {
+        return full ? ROUTING_STORE_DISPATCH(&routing_table, distance_vector_round, &routing_table, 0, n, 0, n)
+                    : ROUTING_STORE_DISPATCH(&routing_table, distance_vector_worklist_round, &routing_table, 0, n, 0, n);
+    }
+    WavefrontTask task = {full, (n + DV_TILE - 1) / DV_TILE, 0, 0};
+    for (task.diagonal = 0; task.diagonal < 2 * task.tiles - 1; task.diagonal++) {
+        int first = task.diagonal < task.tiles ? 0 : task.diagonal - task.tiles + 1; // 반대각선의 첫 행 타일
+        int last = task.diagonal < task.tiles ? task.diagonal : task.tiles - 1;
+        steal_pool_run(dv_threads, last - first + 1, wavefront_tile, &task);
+    }
+    return task.changed;
+}
+
+// 한 라운드 수행: 초기화 직후나 지난 라운드에 바뀐 칸이 많으면 모든 칸을, 아니면 바뀐 칸을 거치는 경로만 계산
+// 두 라운드 모두 차례대로 모든 칸을 계산하는 라운드와 결과가 같으므로 비용이 적은 쪽을 고른다.
+// 작업 목록 라운드는 칸마다 바뀐 칸 수에 비례해 스칼라로, 모든 칸 라운드는 노드 수에 비례해 SIMD 로 계산한다.
+// has_changes 는 값을 바꾼 칸이 있었는지 (작업 목록이 비면 0)
+void distance_vector() {
+    long long cells = (long long)node_count * node_count;
+    int full = worklist.full || worklist.last_writes * 32 > cells;
+    begin_round();
+    if (full) {
+        if (!cost_column_valid) ROUTING_STORE_DISPATCH(&routing_table, build_cost_column, &routing_table);
+        run_round(1);
+        worklist.full = 0;
+    } else if (run_round(0)) {
+        cost_column_valid = 0; // 전치 복사본과 달라짐
+    }
+    worklist.last_writes = 0;
+    for (int i = 0; i < node_count; i++) worklist.last_writes += worklist.row_cur[i].count;
+    has_changes = worklist.last_writes > 0;
+}
+
+// 작업 목록을 노드 수에 맞게 준비하고 비움, 다음 라운드는 모든 칸을 계산
+void reset_worklist() {
+    if (worklist.row_prev == NULL) {
+        worklist.row_prev = (IndexList *)calloc(node_count + 1, sizeof(IndexList));
+        worklist.row_cur = (IndexList *)calloc(node_count + 1, sizeof(IndexList));
+        worklist.col_prev = (IndexList *)calloc(node_count + 1, sizeof(IndexList));
+        worklist.col_cur = (IndexList *)calloc(node_count + 1, sizeof(IndexList));
+        if (!worklist.row_prev || !worklist.row_cur || !worklist.col_prev || !worklist.col_cur) {
+            printf("Error: out of memory.\n");
+            exit(1);
+        }
+    }
+    for (int i = 0; i < node_count; i++) {
+        worklist.row_prev[i].count = worklist.row_cur[i].count = 0;
+        worklist.col_prev[i].count = worklist.col_cur[i].count = 0;
+    }
+    worklist.full = 1;
+}
+
+void free_worklist() {
+    IndexList *lists[4] = {worklist.row_prev, worklist.row_cur, worklist.col_prev, worklist.col_cur};
+    for (int l = 0; l < 4; l++) {
+        if (lists[l] == NULL) continue;
+        for (int i = 0; i < node_count; i++) free(lists[l][i].items);
+        free(lists[l]);
+    }
 }
 
 void initialize_routing_table() {
+    int min_cost = 0, max_cost = INFINITY_COST; // 저장소 비용 폭을 정할 링크 비용 범위
+    for (int i = 0; i < link_count; i++) {
+        if (link_table[i].cost < min_cost) min_cost = link_table[i].cost;
+        if (link_table[i].cost > max_cost) max_cost = link_table[i].cost;
+    }
+    routing_store_prepare(&routing_table, node_count, min_cost, max_cost);
+
     // 초기화 루프를 한 번으로 줄이기
     for (int i = 0; i < node_count; i++) { // 모든 노드에 대해
         for (int j = 0; j < node_count; j++) { // 모든 목적지에 대해
-            routing_table[i][j].cost = (i == j) ? 0 : INFINITY_COST; // 초기 비용 설정
-            routing_table[i][j].next_hop = (i == j) ? i : NOT_EXIST; // 초기 다음 홉 설정
+            store_set(&routing_table, i, j, (i == j) ? 0 : INFINITY_COST, (i == j) ? i : NOT_EXIST); // 초기 비용과 다음 홉 설정
         }
     }
 
@@ -131,43 +454,41 @@ void initialize_routing_table() {
         int cost = link_table[i].cost;
 
         // 링크 비용 및 다음 홉 설정
-        routing_table[source][destination].cost = cost;
-        routing_table[source][destination].next_hop = destination;
-        routing_table[destination][source].cost = cost;
-        routing_table[destination][source].next_hop = source;
+        store_set(&routing_table, source, destination, cost, destination);
+        store_set(&routing_table, destination, source, cost, source);
     }
+    reset_worklist(); // 새 테이블은 모든 칸을 다시 계산
+    cost_column_valid = 0; // 다음 라운드에서 전치 복사본을 새로 만듦
+}
+
+// 링크 테이블 끝에 링크 추가 (노드 번호가 범위를 벗어난 링크는 무시)
+void add_link(int source, int destination, int cost) {
+    if (source < 0 || source >= node_count || destination < 0 || destination >= node_count) return;
+    if (link_count == link_capacity) {
+        link_capacity = link_capacity ? link_capacity * 2 : 256;
+        link_table = (Link *)realloc(link_table, sizeof(Link) * link_capacity);
+        if (link_table == NULL) {
+            printf("Error: out of memory.\n");
+            exit(1);
+        }
+    }
+    link_table[link_count].source = source;
+    link_table[link_count].destination = destination;
+    link_table[link_count].cost = cost;
+    link_count++; // 링크 수 증가
 }
 
 void read_topology() {
-    fscanf(topology_file, "%d", &node_count); // 노드 수 읽기
-    while (fscanf(topology_file, "%d %d %d", &link_table[link_count].source, &link_table[link_count].destination, &link_table[link_count].cost) == 3) {
-        link_count++; // 링크 수 증가 및 다음 링크로 이동
+    int source, destination, cost;
+    if (fscanf(topology_file, "%d", &node_count) != 1 || node_count < 0) node_count = 0; // 노드 수 읽기
+    while (fscanf(topology_file, "%d %d %d", &source, &destination, &cost) == 3) {
+        add_link(source, destination, cost);
     }
 }
 
 void process_messages() {
-    rewind(message_file); // 메시지 파일의 처음으로 이동
-    int source, destination;
-    char message[MAX_MESSAGE_LENGTH];
-    char buffer[1024]; // 출력 버퍼
-    while (fscanf(message_file, "%d %d %[^\n]", &source, &destination, message) == 3) {
-        int offset = 0;
-        offset += snprintf(buffer + offset, sizeof(buffer) - offset, "from %d to %d cost ", source, destination); // 메시지 정보 출력 시작
-        int next = routing_table[source][destination].next_hop; // 다음 홉 가져오기
-        if (next == -1) { // 경로가 없으면
-            offset += snprintf(buffer + offset, sizeof(buffer) - offset, "infinite hops unreachable "); // 도달 불가 메시지 출력
-        } else {
-            offset += snprintf(buffer + offset, sizeof(buffer) - offset, "%d hops ", routing_table[source][destination].cost); // 총 비용 출력
-            offset += snprintf(buffer + offset, sizeof(buffer) - offset, "%d ", source); // 출발 노드 출력
-            while (next != destination) { // 도착지에 도달할 때까지
-                offset += snprintf(buffer + offset, sizeof(buffer) - offset, "%d ", next); // 다음 홉 출력
-                next = routing_table[next][destination].next_hop; // 다음 노드로 이동
-            }
-        }
-        offset += snprintf(buffer + offset, sizeof(buffer) - offset, "message %s\n", message); // 메시지 내용 출력
-        fputs(buffer, output_file); // 버퍼 내용을 출력 파일에 기록
-    }
-    fputs("\n", output_file); // 메시지 사이에 빈 줄 삽입
+    message_batch_refresh(&messages, &routing_table); // 다음 홉이나 비용이 바뀐 목적지의 경로만 다시 만듦
+    message_batch_write(&messages, &writer);
 }
 
 void update_link_cost(int source, int destination, int new_cost) {
@@ -183,11 +504,428 @@ void update_link_cost(int source, int destination, int new_cost) {
         }
     }
     if (!found && new_cost != INFINITY_COST) { // 링크를 찾지 못했으면
-        link_table[link_count].source = source; // 새로운 링크 추가
-        link_table[link_count].destination = destination; // 새로운 링크 추가
-        link_table[link_count].cost = new_cost; // 새로운 링크 비용 설정
-        link_count++; // 링크 수 증가
+        add_link(source, destination, new_cost); // 새로운 링크 추가
+    }
+}
+
+typedef struct {
+    int from;
+    int to;
+    int cost;
+    int order; // 링크 테이블에서의 순서
+} NeighborEntry;
+
+int compare_neighbor(const void *a, const void *b) {
+    const NeighborEntry *x = (const NeighborEntry *)a;
+    const NeighborEntry *y = (const NeighborEntry *)b;
+    if (x->from != y->from) return x->from < y->from ? -1 : 1;
+    if (x->to != y->to) return x->to < y->to ? -1 : 1;
+    return x->order < y->order ? -1 : x->order > y->order;
+}
+
+// 링크 테이블로 이웃 목록을 만듦 (같은 노드 쌍은 마지막 링크)
+// 끊긴 링크도 비용 INFINITY_COST 로 넣는다. 그런 이웃을 거치는 경로는 최소 비용이 될 수 없고,
+// 도달할 수 없는 칸의 값을 initialize_routing_table 과 같게 (INFINITY_COST, 그 이웃) 두는 데만 쓴다.
+// 모든 링크 비용이 1 ~ INFINITY_COST 이면 1, 아니면 다시 수렴할 수 없으므로 0
+int build_neighbors() {
+    NeighborEntry *entries = (NeighborEntry *)malloc(sizeof(NeighborEntry) * 2 * link_count + 1);
+    free(neighbor_start);
+    free(neighbor_node);
+    free(neighbor_cost);
+    neighbor_start = (int *)calloc(node_count + 1, sizeof(int));
+    neighbor_node = (int *)malloc(sizeof(int) * 2 * link_count + 1);
+    neighbor_cost = (int *)malloc(sizeof(int) * 2 * link_count + 1);
+    if (!entries || !neighbor_start || !neighbor_node || !neighbor_cost) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    int entry_count = 0;
+    for (int i = 0; i < link_count; i++) {
+        Link *link = &link_table[i];
+        if (link->source == link->destination) continue; // 자기 자신으로의 링크는 대각선에만 반영
+        entries[entry_count++] = (NeighborEntry){link->source, link->destination, link->cost, i};
+        entries[entry_count++] = (NeighborEntry){link->destination, link->source, link->cost, i};
+    }
+    qsort(entries, entry_count, sizeof(NeighborEntry), compare_neighbor);
+
+    int usable = 1;
+    int count = 0;
+    for (int i = 0; i < entry_count; i++) {
+        if (i + 1 < entry_count && entries[i + 1].from == entries[i].from && entries[i + 1].to == entries[i].to) continue;
+        if (entries[i].cost < 1 || entries[i].cost > INFINITY_COST) usable = 0;
+        neighbor_start[entries[i].from + 1]++;
+        neighbor_node[count] = entries[i].to;
+        neighbor_cost[count] = entries[i].cost;
+        count++;
+    }
+    for (int i = 0; i < node_count; i++) neighbor_start[i + 1] += neighbor_start[i];
+    free(entries);
+    return usable;
+}
+
+// 노드 k 가 이웃 i 에게 알리는 목적지 j 까지의 비용 (split horizon 으로 알리지 않으면 -1)
+static inline int advertised_cost(int k, int i, int j) {
+    if (k == j) return 0;
+    int cost = store_cost(&routing_table, k, j);
+    if (advertise_mode != ADVERTISE_ALL && store_next_hop(&routing_table, k, j) == i) { // i 를 거치는 경로
+        return advertise_mode == ADVERTISE_SPLIT_HORIZON ? -1 : INFINITY_COST;
+    }
+    return cost;
+}
+
+// 이웃들이 알린 벡터로 노드 i 의 벡터를 다시 계산하고 바뀐 칸 수 반환
+// 다음 홉은 최소 비용을 내는 가장 작은 이웃이다 (-j 의 partition_recompute 와 같은 규칙).
+// 도달할 수 없으면 라운드 방식처럼 초기값 (끊긴 직접 링크가 있으면 (INFINITY_COST, j), 없으면 NOT_EXIST) 으로 둔다.
+int recompute_vector(int i) {
+    int updates = 0;
+    for (int j = 0; j < node_count; j++) {
+        if (j == i) continue;
+        int best_cost = INFINITY_COST;
+        int best_next_hop = NOT_EXIST;
+        int unreachable_next_hop = NOT_EXIST;
+        for (int e = neighbor_start[i]; e < neighbor_start[i + 1]; e++) {
+            int k = neighbor_node[e];
+            if (neighbor_cost[e] >= INFINITY_COST) { // 끊긴 링크
+                if (k == j) unreachable_next_hop = j;
+                continue;
+            }
+            int advertised = advertised_cost(k, i, j);
+            if (advertised < 0) continue;
+            int cost = neighbor_cost[e] + advertised;
+            if (cost < best_cost) { // 이웃은 번호 순
+                best_cost = cost;
+                best_next_hop = k;
+            }
+        }
+
+        int current_cost = store_cost(&routing_table, i, j);
+        if (best_cost >= INFINITY_COST) best_next_hop = unreachable_next_hop;
+        if (best_cost != current_cost || best_next_hop != store_next_hop(&routing_table, i, j)) {
+            store_set(&routing_table, i, j, best_cost, best_next_hop);
+            updates++;
+        }
+    }
+    return updates;
+}
+
+// 노드 쌍 (a, b) 의 링크가 바뀐 뒤 이전 테이블에서 다시 수렴
+// 첫 라운드는 a 와 b 만 벡터를 다시 계산하고 (테이블을 라운드 방식으로 만들었으면 모든 노드), 그 뒤로는
+// 지난 라운드에 벡터가 바뀐 노드의 이웃만 다시 계산한다. 다시 계산할 노드가 없으면 끝난다.
+// 끝난 상태는 모든 칸이 이웃의 마지막 값으로 다시 계산된 상태이고 그런 상태는 하나뿐이라
+// (비용은 최단 거리, 다음 홉은 그 비용을 내는 가장 작은 이웃), -j 의 비동기 계산과 테이블이 같다.
+// 걸린 라운드와 바뀐 칸 수를 출력한다.
+void reconverge(int a, int b) {
+    char *pending = (char *)calloc(node_count + 1, 1); // 이번 라운드에 다시 계산할 노드
+    char *next_pending = (char *)calloc(node_count + 1, 1);
+    if (!pending || !next_pending) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    int rounds = 0;
+    long long updates = 0;
+    int any = 0;
+    if (!table_canonical) { // 라운드 방식의 테이블은 비용이 같은 경로의 다음 홉이 다를 수 있음
+        memset(pending, 1, node_count);
+        any = node_count > 0;
+    } else if (a >= 0 && a < node_count && b >= 0 && b < node_count && a != b) {
+        pending[a] = pending[b] = 1;
+        any = 1;
+    }
+    while (any) {
+        rounds++;
+        any = 0;
+        for (int i = 0; i < node_count; i++) {
+            if (!pending[i]) continue;
+            int changed = recompute_vector(i);
+            if (changed == 0) continue;
+            updates += changed;
+            for (int e = neighbor_start[i]; e < neighbor_start[i + 1]; e++) next_pending[neighbor_node[e]] = 1;
+            any = 1;
+        }
+        char *t = pending;
+        pending = next_pending;
+        next_pending = t;
+        memset(next_pending, 0, node_count);
+    }
+    free(pending);
+    free(next_pending);
+    table_canonical = 1;
+    printf("change %d %d: reconverged in %d rounds, %lld updates\n", a, b, rounds, updates);
+}
+
+// 노드를 스레드에 나눈 비동기 계산 (-j)
+//
+// 스레드마다 연속한 노드 구간을 맡아 그 행만 쓴다. (i, j) 칸은 이웃 k 의 (k, j) 칸으로 다시 계산하고,
+// 값이 바뀌면 i 의 이웃들에게 (i, j) 가 바뀌었다고 알린다. 같은 스레드의 이웃은 바로 작업 큐에 넣고,
+// 다른 스레드의 이웃은 스레드 쌍마다의 잠금 없는 우편함으로 알린다. 다른 스레드의 행은 원자적으로 읽는다.
+// 라운드나 배리어 없이 outstanding (일하는 스레드 수 + 우편함에 있는 알림 수) 이 0 이 되면 끝난다.
+// 칸은 recompute_vector 와 같은 규칙으로 다시 계산한다 (다음 홉은 최소 비용을 내는 가장 작은 이웃,
+// 도달할 수 없으면 끊긴 직접 링크가 있을 때 (INFINITY_COST, j), 없으면 NOT_EXIST). 끝난 상태는 모든 칸이
+// 이웃의 마지막 값으로 다시 계산된 상태이고 그런 상태는 하나뿐이라, 스레드 수나 처리 순서와 관계없이
+// -w 의 reconverge 와 테이블이 같다.
+
+static void partition_push(DvPartition *part, int i, int j) {
+    char *pending = &part->pending[(size_t)(i - part->begin) * node_count + j];
+    if (*pending) return;
+    *pending = 1;
+    if (part->queue_count == part->queue_capacity) {
+        if (part->queue_head >= part->queue_capacity / 2) { // 절반 이상이 처리한 칸이면 앞으로 당겨 재사용
+            part->queue_count -= part->queue_head;
+            memmove(part->queue, part->queue + part->queue_head, sizeof(long long) * part->queue_count);
+            part->queue_head = 0;
+        }
+        if (part->queue_count == part->queue_capacity) {
+            part->queue_capacity = part->queue_capacity ? part->queue_capacity * 2 : 1024;
+            part->queue = (long long *)realloc(part->queue, sizeof(long long) * part->queue_capacity);
+            if (part->queue == NULL) {
+                printf("Error: out of memory.\n");
+                exit(1);
+            }
+        }
+    }
+    part->queue[part->queue_count++] = (long long)i * node_count + j;
+}
+
+// (k, j) 가 바뀌었음: 이 스레드가 맡은 k 의 이웃 i 의 (i, j) 를 다시 계산하도록
+static void partition_notified(DvPartition *part, int k, int j) {
+    for (int e = neighbor_start[k]; e < neighbor_start[k + 1]; e++) {
+        int i = neighbor_node[e];
+        if (i >= part->begin && i < part->end && i != j) partition_push(part, i, j);
+    }
+}
+
+// (i, j) 가 바뀌었음을 i 의 이웃을 맡은 스레드에 알림 (스레드마다 한 번)
+static void partition_notify(DvPartition *part, int i, int j) {
+    int stamp = ++part->stamp;
+    for (int e = neighbor_start[i]; e < neighbor_start[i + 1]; e++) {
+        int t = node_partition[neighbor_node[e]];
+        if (part->sent_stamp[t] == stamp) continue;
+        part->sent_stamp[t] = stamp;
+        if (t == part->id) {
+            partition_notified(part, i, j);
+            continue;
+        }
+        if (part->outbox_count[t] == part->outbox_capacity[t]) {
+            part->outbox_capacity[t] = part->outbox_capacity[t] ? part->outbox_capacity[t] * 2 : 256;
+            part->outbox[t] = (uint64_t *)realloc(part->outbox[t], sizeof(uint64_t) * part->outbox_capacity[t]);
+            if (part->outbox[t] == NULL) {
+                printf("Error: out of memory.\n");
+                exit(1);
+            }
+        }
+        part->outbox[t][part->outbox_count[t]++] = (uint64_t)i << 32 | (uint32_t)j;
+    }
+}
+
+// 쌓인 알림을 우편함에 넣음, 남은 알림이 있으면 1
+static int partition_flush(DvPartition *part) {
+    int left = 0;
+    for (int t = 0; t < dv_threads; t++) {
+        int count = part->outbox_count[t];
+        if (count == 0) continue;
+        __atomic_add_fetch(&outstanding, count, __ATOMIC_SEQ_CST); // 받는 쪽이 빼기 전에 더함
+        int sent = mailbox_push(&mailboxes[part->id * dv_threads + t], part->outbox[t], count);
+        if (sent < count) {
+            __atomic_sub_fetch(&outstanding, count - sent, __ATOMIC_SEQ_CST); // 이 스레드가 일하는 중이라 0 이 되지 않음
+            memmove(part->outbox[t], part->outbox[t] + sent, sizeof(uint64_t) * (count - sent));
+            left = 1;
+        }
+        part->outbox_count[t] = count - sent;
+    }
+    return left;
+}
+
+// 받은 알림 처리, 받은 알림이 있으면 1
+static int partition_receive(DvPartition *part) {
+    uint64_t items[256];
+    int received = 0;
+    for (int t = 0; t < dv_threads; t++) {
+        if (t == part->id) continue;
+        int count;
+        while ((count = mailbox_pop(&mailboxes[t * dv_threads + part->id], items, 256)) > 0) {
+            if (!part->busy) { // 알림 몫을 빼기 전에 일하는 스레드로 셈
+                __atomic_add_fetch(&outstanding, 1, __ATOMIC_SEQ_CST);
+                part->busy = 1;
+            }
+            for (int c = 0; c < count; c++) partition_notified(part, (int)(items[c] >> 32), (int)(uint32_t)items[c]);
+            __atomic_sub_fetch(&outstanding, count, __ATOMIC_SEQ_CST);
+            received = 1;
+        }
+    }
+    return received;
+}
+
+// (i, j) 를 이웃의 값으로 다시 계산하고 바뀌면 알림
+template <typename C, typename H>
+static void partition_recompute(DvPartition *part, C *cost, H *next, int i, int j) {
+    int n = node_count;
+    int best_cost = INFINITY_COST;
+    int best_next_hop = NOT_EXIST;
+    int unreachable_next_hop = NOT_EXIST;
+    for (int e = neighbor_start[i]; e < neighbor_start[i + 1]; e++) { // 이웃은 번호 순
+        int k = neighbor_node[e];
+        if (neighbor_cost[e] >= INFINITY_COST) { // 끊긴 링크
+            if (k == j) unreachable_next_hop = j;
+            continue;
+        }
+        int advertised = 0;
+        if (k != j) {
+            advertised = __atomic_load_n(&cost[(size_t)k * n + j], __ATOMIC_RELAXED);
+            if (advertise_mode != ADVERTISE_ALL && __atomic_load_n(&next[(size_t)k * n + j], __ATOMIC_RELAXED) == i) {
+                if (advertise_mode == ADVERTISE_SPLIT_HORIZON) continue;
+                advertised = INFINITY_COST;
+            }
+        }
+        if (neighbor_cost[e] + advertised < best_cost) {
+            best_cost = neighbor_cost[e] + advertised;
+            best_next_hop = k;
+        }
+    }
+    size_t cell = (size_t)i * n + j;
+    if (best_cost >= INFINITY_COST) best_next_hop = unreachable_next_hop;
+    if (cost[cell] == best_cost && next[cell] == best_next_hop) return;
+    __atomic_store_n(&cost[cell], (C)best_cost, __ATOMIC_RELAXED); // 알림을 넣는 release 보다 먼저
+    __atomic_store_n(&next[cell], (H)best_next_hop, __ATOMIC_RELAXED);
+    part->updates++;
+    partition_notify(part, i, j);
+}
+
+typedef struct {
+    DvPartition *part;
+    const int *seeds; // 처음에 모든 칸을 다시 계산할 노드 (NULL 이면 모든 노드)
+    int seed_count;
+} PartitionTask;
+
+template <typename C, typename H>
+static int partition_run(RoutingStore *store, PartitionTask *task) {
+    DvPartition *part = task->part;
+    C *cost = (C *)store->cost;
+    H *next = (H *)store->next_hop;
+    int n = node_count;
+    for (int s = 0; s < (task->seeds ? task->seed_count : n); s++) {
+        int i = task->seeds ? task->seeds[s] : s;
+        if (i < part->begin || i >= part->end) continue;
+        for (int j = 0; j < n; j++) {
+            if (j != i) partition_recompute<C, H>(part, cost, next, i, j);
+        }
+        partition_flush(part);
+    }
+
+    while (1) {
+        int received = partition_receive(part);
+        for (int w = 0; w < WORK_BATCH && part->queue_head < part->queue_count; w++) {
+            long long cell = part->queue[part->queue_head++];
+            int i = (int)(cell / n), j = (int)(cell % n);
+            part->pending[(size_t)(i - part->begin) * n + j] = 0;
+            partition_recompute<C, H>(part, cost, next, i, j);
+        }
+        int left = partition_flush(part);
+        if (part->queue_head == part->queue_count) part->queue_head = part->queue_count = 0;
+        if (received || left || part->queue_count > 0) continue;
+
+        if (part->busy) { // 할 일이 없음
+            part->busy = 0;
+            __atomic_sub_fetch(&outstanding, 1, __ATOMIC_SEQ_CST);
+        }
+        if (__atomic_load_n(&outstanding, __ATOMIC_SEQ_CST) == 0) break; // 모든 스레드가 쉬고 알림도 없음
+        sched_yield();
+    }
+    return 0;
+}
+
+static void *partition_thread(void *arg) {
+    ROUTING_STORE_DISPATCH(&routing_table, partition_run, &routing_table, (PartitionTask *)arg);
+    return NULL;
+}
+
+// seeds 노드의 모든 칸부터 시작해 바뀐 칸이 없을 때까지 비동기로 계산하고 바꾼 칸 수 반환
+// (seeds 가 NULL 이거나 테이블을 라운드 방식으로 만들었으면 모든 노드, build_neighbors 로 이웃 목록을 만든 뒤 호출)
+// 끝난 상태에서 (i, j) 는 이웃의 마지막 값으로 정해지므로, 이미 그런 상태인 테이블에서 시작하면
+// 한 번도 다시 계산되지 않은 칸도 그대로 맞다.
+long long parallel_converge(const int *seeds, int seed_count) {
+    int threads = dv_threads;
+    partitions = (DvPartition *)calloc(threads, sizeof(DvPartition));
+    mailboxes = (Mailbox *)calloc((size_t)threads * threads, sizeof(Mailbox));
+    PartitionTask *tasks = (PartitionTask *)calloc(threads, sizeof(PartitionTask));
+    pthread_t *tids = (pthread_t *)calloc(threads, sizeof(pthread_t));
+    node_partition = (int *)malloc(sizeof(int) * node_count + 1);
+    if (!partitions || !mailboxes || !tasks || !tids || !node_partition) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    for (int t = 0; t < threads * threads; t++) {
+        if (t / threads != t % threads) mailbox_init(&mailboxes[t], MAILBOX_SIZE);
     }
+    for (int t = 0; t < threads; t++) {
+        DvPartition *part = &partitions[t];
+        part->id = t;
+        part->begin = (int)((long long)node_count * t / threads);
+        part->end = (int)((long long)node_count * (t + 1) / threads);
+        for (int i = part->begin; i < part->end; i++) node_partition[i] = t;
+        part->pending = (char *)calloc((size_t)(part->end - part->begin) * node_count + 1, 1);
+        part->outbox = (uint64_t **)calloc(threads, sizeof(uint64_t *));
+        part->outbox_count = (int *)calloc(threads, sizeof(int));
+        part->outbox_capacity = (int *)calloc(threads, sizeof(int));
+        part->sent_stamp = (int *)calloc(threads, sizeof(int));
+        if (!part->pending || !part->outbox || !part->outbox_count || !part->outbox_capacity || !part->sent_stamp) {
+            printf("Error: out of memory.\n");
+            exit(1);
+        }
+        part->busy = 1;
+        tasks[t].part = part;
+        tasks[t].seeds = table_canonical ? seeds : NULL; // 다른 방식으로 만든 테이블이면 모든 칸을 다시 계산
+        tasks[t].seed_count = seed_count;
+    }
+    outstanding = threads; // 처음에는 모든 스레드가 일함
+
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&tids[t], NULL, partition_thread, &tasks[t]) != 0) {
+            printf("Error: create thread.\n");
+            exit(1);
+        }
+    }
+    partition_thread(&tasks[0]); // 0 번 구간은 호출한 스레드가 맡음
+    for (int t = 1; t < threads; t++) pthread_join(tids[t], NULL);
+
+    long long updates = 0;
+    for (int t = 0; t < threads; t++) {
+        DvPartition *part = &partitions[t];
+        updates += part->updates;
+        for (int u = 0; u < threads; u++) free(part->outbox[u]);
+        free(part->outbox);
+        free(part->outbox_count);
+        free(part->outbox_capacity);
+        free(part->sent_stamp);
+        free(part->pending);
+        free(part->queue);
+    }
+    for (int t = 0; t < threads * threads; t++) mailbox_free(&mailboxes[t]);
+    free(partitions);
+    free(mailboxes);
+    free(tasks);
+    free(tids);
+    free(node_partition);
+    table_canonical = 1;
+    return updates;
+}
+
+// 자기 자신으로의 링크가 있으면 1 (라운드 방식은 그 비용을 대각선에 두고 계산하므로 다시 수렴하지 않음)
+static int has_self_link() {
+    for (int i = 0; i < link_count; i++) {
+        if (link_table[i].source == link_table[i].destination) return 1;
+    }
+    return 0;
+}
+
+// 링크 테이블로 라우팅 테이블을 새로 계산 (라운드 방식, -j 면 라운드마다 타일을 스레드로 나눔)
+void converge_from_scratch() {
+    initialize_routing_table(); // 라우팅 테이블 초기화
+    table_canonical = 0;
+    int iterations = 0;
+    do {
+        distance_vector(); // 거리 벡터 알고리즘 수행
+        iterations++;
+    } while (has_changes != 0 && iterations < node_count); // 변화가 없거나 최대 반복 횟수 도달 시 종료
 }
 
 void apply_changes() {
@@ -196,13 +934,23 @@ void apply_changes() {
     int source, destination, cost;
     while (fscanf(change_file, "%d %d %d", &source, &destination, &cost) == 3) {
         update_link_cost(source, destination, cost); // 링크 비용 업데이트
-        initialize_routing_table(); // 라우팅 테이블 초기화
-
-        int iterations = 0;
-        do {
-            distance_vector(); // 거리 벡터 알고리즘 수행
-            iterations++;
-        } while (has_changes != 0 && iterations < node_count); // 변화가 없거나 최대 반복 횟수 도달 시 종료
+        // 자기 자신으로의 링크가 있으면 라운드 방식은 대각선을 그 비용부터 고리 비용으로 줄여 가므로 처음부터 다시 계산
+        int self_link = has_self_link();
+        if (warm_start && !self_link && build_neighbors()) { // 이전 테이블에서 다시 수렴
+            if (dv_threads) {
+                int seeds[2] = {source, destination};
+                long long updates = parallel_converge(seeds, 2);
+                printf("change %d %d: reconverged on %d threads, %lld updates\n", source, destination, dv_threads, updates);
+            } else {
+                reconverge(source, destination);
+            }
+        } else {
+            if (warm_start) {
+                printf("change %d %d: %s, recomputed from scratch\n", source, destination,
+                       self_link ? "self link present" : "link cost out of range");
+            }
+            converge_from_scratch();
+        }
 
         print_routing_table(); // 라우팅 테이블 출력
 
@@ -218,13 +966,10 @@ int main(int argc, char **argv) {
     }
 
     read_topology(); // 토폴로지 읽기
-    initialize_routing_table(); // 라우팅 테이블 초기화
-
-    int iterations = 0;
-    do {
-        distance_vector(); // 거리 벡터 알고리즘 수행
-        iterations++;
-    } while (has_changes != 0 && iterations < node_count); // 변화가 없거나 최대 반복 횟수 도달 시 종료
+    message_batch_load(&messages, message_file, node_count); // 메시지 파일 읽기
+    writer_init(&writer, output_file);
+    minplus_init(); // CPU 에 맞는 min-plus 커널 선택
+    converge_from_scratch(); // 라우팅 테이블 계산
 
     print_routing_table(); // 라우팅 테이블 출력
 
@@ -236,10 +981,20 @@ int main(int argc, char **argv) {
         apply_changes(); // 변경 사항 적용
     }
 
+    writer_free(&writer);
     fclose(topology_file);
     fclose(message_file);
     if (change_file) fclose(change_file); // change_file이 NULL이 아닌 경우에만 닫기
     fclose(output_file);
+    if (snapshot_file >= 0) close(snapshot_file);
+    free(link_table);
+    routing_store_free(&routing_table);
+    message_batch_free(&messages);
+    free_worklist();
+    free(cost_column);
+    free(neighbor_start);
+    free(neighbor_node);
+    free(neighbor_cost);
 
     printf("Complete. Output file written to output_dv.txt.\n");
 
@@ -0,0 +1,731 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "steal_pool.h"
+#include "timer_wheel.h"
+
+// 거리 벡터 프로토콜 이산 사건 시뮬레이터
+//
+// distvec 와 같은 topologyfile / changesfile 을 읽고, 노드마다 거리 벡터를 가진 에이전트가 링크 지연을 두고
+// 이웃과 갱신 메시지를 주고받는 과정을 시뮬레이션한다. 벡터가 바뀐 노드는 바로 이웃에게 바뀐 값을 보낸다
+// (triggered update). 단, 한 노드의 갱신은 노드마다 정해진 전송 시각(-u 간격, 기본은 매 틱)에 모아서 보낸다.
+// 받는 대로 바로 보내면 지연이 제각각일 때 비동기 벨만-포드의 메시지 수가 지수적으로 늘 수 있기 때문이다.
+// 처음 수렴과 changesfile 의 변경마다 수렴 시간, 메시지 수, 경로 변경 수,
+// 전달 루프(다음 홉을 따라가면 자기 자신으로 돌아오는 경우)가 생긴 횟수를 출력한다.
+//
+// 목적지마다의 경로 값은 이웃의 같은 목적지 값에만 의존하고, 갱신은 값이 바뀌는 즉시 보내므로
+// 전송 시각도 노드마다 고정이라 목적지 하나씩 따로 시뮬레이션해도 시각은 같다. 그래서 목적지 하나에 노드 / 링크 수만큼의 상태만 두고,
+// 목적지들을 스레드에 나눠 시뮬레이션한다 (노드 x 노드 테이블이 필요 없음). 메시지는 목적지 하나의
+// 경로 광고 하나로 센다. 노드가 많으면 -n 으로 고르게 고른 일부 목적지만 시뮬레이션하며,
+// 이때 수렴 시간은 그 목적지들의 최댓값, 나머지는 그 목적지들의 합이다.
+// 기본은 다익스트라로 구한 수렴 상태에서 변경만 시뮬레이션하고, -c 면 모든 노드가 빈 벡터로 시작한다.
+
+#define NOT_EXIST -1 // 존재하지 않음을 나타내는 상수
+#define INFINITY_COST 999 // 무한 비용을 나타내는 상수 (이 이상의 링크 비용은 끊긴 링크)
+#define DEFAULT_SAMPLE 256 // 노드가 이보다 많으면 기본으로 이만큼의 목적지만 시뮬레이션
+#define UNSENT -1 // 이웃에게 아직 아무 값도 보내지 않음
+
+typedef struct {
+    int source; // 링크의 출발 노드
+    int destination; // 링크의 도착 노드
+    int cost; // 링크의 비용
+} Link;
+
+typedef struct {
+    int source; // 바뀐 링크의 한쪽 노드
+    int destination; // 다른 쪽 노드
+    int cost; // changesfile 에 적힌 비용
+    int edge; // source 쪽 이웃 목록에서 destination 의 위치 (없으면 NOT_EXIST)
+    int pair_cost; // 변경 뒤 두 노드 사이의 실제 링크 비용
+} Change;
+
+// 한 단계 (처음 수렴, 변경 하나) 의 통계
+typedef struct {
+    uint32_t converge_time; // 단계 시작부터 마지막 이벤트까지의 틱 (목적지 중 최댓값)
+    long long messages; // 보낸 경로 광고 수
+    long long route_changes; // 노드의 비용이나 다음 홉이 바뀐 횟수
+    long long loops; // 다음 홉을 바꿔 전달 루프가 생긴 횟수
+    int longest_loop; // 가장 긴 루프의 노드 수
+} PhaseStats;
+
+// 스레드별 목적지 하나의 시뮬레이션 상태
+typedef struct {
+    int destination;
+    int *dist; // 노드의 목적지까지 비용
+    int *hop; // 노드의 다음 홉
+    int *edge_cost; // 이웃 목록 칸별 지금 링크 비용 (변경을 따라 바뀜)
+    int *received; // 이웃 목록 칸 e (노드 u 의 이웃 w) : w 가 u 에게 마지막으로 알린 비용
+    int *sent; // 이웃 목록 칸 e : u 가 w 에게 마지막으로 보낸 비용
+    char *flush_pending; // 노드가 다음 전송 시각에 보낼 갱신이 있는지
+    int *mark; // 루프 검사용 방문 표시
+    int stamp;
+    int *bucket; // 다익스트라: 비용 % INFINITY_COST 별 노드 목록 (링크 비용이 INFINITY_COST 보다 작으므로 원형으로 씀)
+    int *bucket_next; // 같은 버킷의 다음 / 이전 노드
+    int *bucket_prev;
+    TimerWheel wheel; // 메시지 도착 이벤트
+    int *event_edge; // 이벤트별 받는 노드의 이웃 목록 칸 (음수면 노드 -1 - event_edge 의 전송 시각)
+    int *event_cost; // 이벤트별 알린 비용
+    int event_capacity;
+    PhaseStats *phase; // 단계별 통계 (목적지들을 누적)
+    PhaseStats *current; // 지금 단계
+} SimWorker;
+
+FILE *topology_file; // 토폴로지 파일 포인터
+FILE *change_file; // 변경 파일 포인터
+
+Link *link_table; // 링크 정보를 저장할 테이블
+int link_count = 0; // 링크 개수
+int link_capacity = 0; // 링크 테이블 크기
+int node_count; // 노드 개수
+
+Change *change_table; // 변경 목록
+int change_count = 0;
+int change_capacity = 0;
+
+// 이웃 목록 (CSR): 처음 토폴로지와 변경에 나오는 모든 노드 쌍, 노드 u 의 이웃은 edge_node[edge_start[u] .. edge_start[u + 1])
+int *edge_start;
+int *edge_node;
+int *edge_reverse; // 반대 방향 칸
+int *initial_cost; // 처음 토폴로지의 링크 비용 (없거나 끊겼으면 INFINITY_COST)
+int edge_count;
+
+int link_delay = 1; // -d: 링크 하나를 지나는 틱 수
+int update_interval = 1; // -u: 노드가 갱신을 보내는 간격 (틱)
+int delay_by_cost; // -D: 링크 비용만큼의 틱을 지연으로 씀
+int poison_reverse; // -p: 다음 홉 이웃에게는 INFINITY_COST 로 알림
+int cold_start; // -c: 처음 수렴도 시뮬레이션
+int route_infinity = INFINITY_COST; // -i: 이 이상의 경로 비용은 도달할 수 없음
+int sample_count = -1; // -n: 시뮬레이션할 목적지 수 (0 이면 모두)
+int sim_threads; // -j: 스레드 수 (기본은 CPU 수)
+
+int *sample_destination; // 시뮬레이션할 목적지
+SimWorker *workers;
+
+// 함수 선언
+int initialize(int argc, char **argv);
+void add_link(int source, int destination, int cost);
+void read_topology();
+void update_link_cost(int source, int destination, int new_cost);
+int link_pair_cost(int a, int b);
+void read_changes();
+int find_edge(int a, int b);
+void build_edges(const Link *initial_links, int initial_count);
+void init_worker(SimWorker *w);
+void free_worker(SimWorker *w);
+void simulate_destination(void *ctx, int worker, int index);
+void print_report(int samples, double seconds);
+
+static void usage() {
+    printf("usage: dvsim [-d delay | -D] [-u interval] [-p] [-c] [-i infinity] [-n destinations] [-j threads] topologyfile changesfile\n");
+}
+
+int initialize(int argc, char **argv) {
+    int opt;
+    sim_threads = steal_pool_cpus(); // 기본은 모든 코어 사용
+    while ((opt = getopt(argc, argv, "d:Du:pci:n:j:")) != -1) {
+        if (opt == 'd' && atoi(optarg) > 0) {
+            link_delay = atoi(optarg);
+        } else if (opt == 'u' && atoi(optarg) > 0) {
+            update_interval = atoi(optarg);
+        } else if (opt == 'D') {
+            delay_by_cost = 1;
+        } else if (opt == 'p') {
+            poison_reverse = 1;
+        } else if (opt == 'c') {
+            cold_start = 1;
+        } else if (opt == 'i' && atoi(optarg) > 0) {
+            route_infinity = atoi(optarg);
+        } else if (opt == 'n' && atoi(optarg) >= 0) {
+            sample_count = atoi(optarg);
+        } else if (opt == 'j' && atoi(optarg) > 0) {
+            sim_threads = atoi(optarg);
+        } else {
+            usage();
+            return -1;
+        }
+    }
+    argc -= optind - 1; // 옵션을 건너뛴 파일 인자
+    argv += optind - 1;
+    if (argc != 3) { // 인자 개수가 올바른지 확인
+        usage();
+        return -1;
+    }
+
+    topology_file = fopen(argv[1], "r"); // 토폴로지 파일 열기
+    if (topology_file == NULL) {
+        printf("Error: open input file %s.\n", argv[1]);
+        return -1;
+    }
+
+    change_file = fopen(argv[2], "r"); // 변경 파일 열기 (없으면 처음 수렴만)
+
+    return 0; // 초기화 성공
+}
+
+static void *allocate(size_t size) {
+    void *p = malloc(size + 1);
+    if (p == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    return p;
+}
+
+void add_link(int source, int destination, int cost) {
+    if (source < 0 || source >= node_count || destination < 0 || destination >= node_count) return;
+    if (link_count == link_capacity) {
+        link_capacity = link_capacity ? link_capacity * 2 : 256;
+        link_table = (Link *)realloc(link_table, sizeof(Link) * link_capacity);
+        if (link_table == NULL) {
+            printf("Error: out of memory.\n");
+            exit(1);
+        }
+    }
+    link_table[link_count].source = source;
+    link_table[link_count].destination = destination;
+    link_table[link_count].cost = cost;
+    link_count++; // 링크 수 증가
+}
+
+void read_topology() {
+    int source, destination, cost;
+    if (fscanf(topology_file, "%d", &node_count) != 1 || node_count < 0) node_count = 0; // 노드 수 읽기
+    while (fscanf(topology_file, "%d %d %d", &source, &destination, &cost) == 3) {
+        add_link(source, destination, cost);
+    }
+}
+
+// distvec 의 update_link_cost 와 같음 (첫 번째로 맞는 링크를 바꾸고, 없으면 추가)
+void update_link_cost(int source, int destination, int new_cost) {
+    if (new_cost == -999) new_cost = INFINITY_COST; // -999는 링크가 없음을 의미
+
+    int found = 0;
+    for (int i = 0; i < link_count; i++) { // 모든 링크에 대해
+        if ((link_table[i].source == source && link_table[i].destination == destination) ||
+            (link_table[i].source == destination && link_table[i].destination == source)) {
+            link_table[i].cost = new_cost; // 링크 비용 업데이트
+            found = 1; // 링크 찾음 플래그 설정
+            break;
+        }
+    }
+    if (!found && new_cost != INFINITY_COST) { // 링크를 찾지 못했으면
+        add_link(source, destination, new_cost); // 새로운 링크 추가
+    }
+}
+
+// 노드 쌍의 실제 링크 비용 (같은 쌍의 링크가 여럿이면 마지막 링크, 없으면 INFINITY_COST)
+int link_pair_cost(int a, int b) {
+    int cost = INFINITY_COST;
+    for (int i = 0; i < link_count; i++) {
+        if ((link_table[i].source == a && link_table[i].destination == b) ||
+            (link_table[i].source == b && link_table[i].destination == a)) {
+            cost = link_table[i].cost;
+        }
+    }
+    return cost;
+}
+
+// 변경을 모두 읽어 링크 테이블에 차례로 반영하고, 변경마다 바뀐 뒤의 실제 링크 비용을 기록
+void read_changes() {
+    if (change_file == NULL) return;
+    int source, destination, cost;
+    while (fscanf(change_file, "%d %d %d", &source, &destination, &cost) == 3) {
+        if (change_count == change_capacity) {
+            change_capacity = change_capacity ? change_capacity * 2 : 16;
+            change_table = (Change *)realloc(change_table, sizeof(Change) * change_capacity);
+            if (change_table == NULL) {
+                printf("Error: out of memory.\n");
+                exit(1);
+            }
+        }
+        update_link_cost(source, destination, cost);
+        Change *change = &change_table[change_count++];
+        change->source = source;
+        change->destination = destination;
+        change->cost = cost;
+        change->edge = NOT_EXIST;
+        change->pair_cost = link_pair_cost(source, destination);
+    }
+}
+
+// 노드 a 의 이웃 목록에서 b 의 위치 (없으면 NOT_EXIST)
+int find_edge(int a, int b) {
+    int low = edge_start[a], high = edge_start[a + 1];
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (edge_node[mid] < b) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < edge_start[a + 1] && edge_node[low] == b ? low : NOT_EXIST;
+}
+
+static int compare_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return x < y ? -1 : x > y;
+}
+
+// 링크 비용 검사: 끊긴 링크가 아니면 1 이상이어야 함 (0 이하의 비용은 거리 벡터가 수렴하지 않음)
+static int checked_cost(int a, int b, int cost) {
+    if (cost >= INFINITY_COST || cost == -999) return INFINITY_COST; // -999는 링크가 없음을 의미
+    if (cost < 1) {
+        printf("Error: link %d %d has cost %d, the simulator needs costs of at least 1.\n", a, b, cost);
+        exit(1);
+    }
+    return cost;
+}
+
+// 변경까지 반영한 링크 테이블 (링크는 지워지지 않고 비용만 바뀜) 의 모든 노드 쌍으로 이웃 목록을 만들고,
+// 처음 토폴로지의 비용과 변경마다의 위치를 채움
+void build_edges(const Link *initial_links, int initial_count) {
+    edge_start = (int *)calloc(node_count + 2, sizeof(int));
+    int *fill = (int *)calloc(node_count + 1, sizeof(int));
+    int *slots = (int *)allocate(sizeof(int) * 2 * link_count);
+    if (edge_start == NULL || fill == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    for (int i = 0; i < link_count; i++) {
+        if (link_table[i].source == link_table[i].destination) continue; // 자기 자신으로의 링크는 경로와 무관
+        edge_start[link_table[i].source + 1]++;
+        edge_start[link_table[i].destination + 1]++;
+    }
+    for (int i = 0; i < node_count; i++) edge_start[i + 1] += edge_start[i];
+    for (int i = 0; i < link_count; i++) {
+        int a = link_table[i].source, b = link_table[i].destination;
+        if (a == b) continue;
+        slots[edge_start[a] + fill[a]++] = b;
+        slots[edge_start[b] + fill[b]++] = a;
+    }
+
+    // 노드별로 정렬하고 같은 이웃은 하나만 남김
+    edge_count = 0;
+    int begin = 0;
+    for (int u = 0; u < node_count; u++) {
+        int end = edge_start[u + 1];
+        qsort(slots + begin, end - begin, sizeof(int), compare_int);
+        edge_start[u] = edge_count;
+        for (int e = begin; e < end; e++) {
+            if (e > begin && slots[e] == slots[e - 1]) continue;
+            slots[edge_count++] = slots[e];
+        }
+        begin = end;
+    }
+    edge_start[node_count] = edge_count;
+    edge_node = slots;
+
+    edge_reverse = (int *)allocate(sizeof(int) * edge_count);
+    initial_cost = (int *)allocate(sizeof(int) * edge_count);
+    for (int u = 0; u < node_count; u++) {
+        for (int e = edge_start[u]; e < edge_start[u + 1]; e++) {
+            edge_reverse[e] = find_edge(edge_node[e], u);
+            initial_cost[e] = INFINITY_COST;
+        }
+    }
+    for (int i = 0; i < initial_count; i++) { // 같은 쌍은 마지막 링크의 비용
+        int a = initial_links[i].source, b = initial_links[i].destination;
+        if (a == b) continue;
+        int e = find_edge(a, b);
+        initial_cost[e] = initial_cost[edge_reverse[e]] = checked_cost(a, b, initial_links[i].cost);
+    }
+    for (int c = 0; c < change_count; c++) {
+        Change *change = &change_table[c];
+        change->pair_cost = checked_cost(change->source, change->destination, change->pair_cost);
+        if (change->source < 0 || change->source >= node_count || change->destination < 0 ||
+            change->destination >= node_count || change->source == change->destination)
+            continue; // 없는 노드, 자기 자신으로의 링크: 경로에 영향 없음
+        change->edge = find_edge(change->source, change->destination);
+    }
+    free(fill);
+}
+
+void init_worker(SimWorker *w) {
+    w->dist = (int *)allocate(sizeof(int) * node_count);
+    w->hop = (int *)allocate(sizeof(int) * node_count);
+    w->flush_pending = (char *)calloc(node_count + 1, 1);
+    w->mark = (int *)calloc(node_count + 1, sizeof(int));
+    w->stamp = 0;
+    w->bucket = (int *)allocate(sizeof(int) * INFINITY_COST);
+    w->bucket_next = (int *)allocate(sizeof(int) * node_count);
+    w->bucket_prev = (int *)allocate(sizeof(int) * node_count);
+    w->edge_cost = (int *)allocate(sizeof(int) * edge_count);
+    w->received = (int *)allocate(sizeof(int) * edge_count);
+    w->sent = (int *)allocate(sizeof(int) * edge_count);
+    w->phase = (PhaseStats *)calloc(change_count + 1, sizeof(PhaseStats));
+    if (w->flush_pending == NULL || w->mark == NULL || w->phase == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    timer_wheel_init(&w->wheel);
+    w->event_edge = NULL;
+    w->event_cost = NULL;
+    w->event_capacity = 0;
+}
+
+void free_worker(SimWorker *w) {
+    free(w->dist);
+    free(w->hop);
+    free(w->flush_pending);
+    free(w->mark);
+    free(w->bucket);
+    free(w->bucket_next);
+    free(w->bucket_prev);
+    free(w->edge_cost);
+    free(w->received);
+    free(w->sent);
+    free(w->phase);
+    timer_wheel_free(&w->wheel);
+    free(w->event_edge);
+    free(w->event_cost);
+}
+
+// 시각 t 의 이벤트 추가 (edge 는 받는 쪽 이웃 목록 칸, 전송 시각이면 -1 - 노드)
+static void add_event(SimWorker *w, uint32_t t, int edge, int cost) {
+    int event = timer_wheel_add(&w->wheel, t);
+    if (event >= w->event_capacity) { // 휠의 이벤트 번호 수를 따라 늘림
+        w->event_capacity = w->wheel.capacity;
+        w->event_edge = (int *)realloc(w->event_edge, sizeof(int) * w->event_capacity);
+        w->event_cost = (int *)realloc(w->event_cost, sizeof(int) * w->event_capacity);
+        if (w->event_edge == NULL || w->event_cost == NULL) {
+            printf("Error: out of memory.\n");
+            exit(1);
+        }
+    }
+    w->event_edge[event] = edge;
+    w->event_cost[event] = cost;
+}
+
+// 이웃 목록 칸 e (노드 u 의 이웃 w) 로 u 가 w 에게 비용 cost 를 알림 (링크 지연 뒤 도착)
+static void send_message(SimWorker *w, int e, int cost) {
+    int delay = delay_by_cost ? w->edge_cost[e] : link_delay;
+    add_event(w, w->wheel.now + (uint32_t)delay, edge_reverse[e], cost);
+    w->current->messages++;
+}
+
+// 노드 u 가 이웃 w 에게 알릴 비용
+static inline int advertised_cost(const SimWorker *w, int u, int neighbor) {
+    if (poison_reverse && w->hop[u] == neighbor) return route_infinity;
+    return w->dist[u];
+}
+
+// 노드 u 가 이웃마다 지난번에 보낸 값과 달라진 비용을 보냄, 보낸 메시지 수 반환
+static int advertise(SimWorker *w, int u) {
+    int sent = 0;
+    for (int e = edge_start[u]; e < edge_start[u + 1]; e++) {
+        if (w->edge_cost[e] >= INFINITY_COST) continue; // 끊긴 링크
+        int cost = advertised_cost(w, u, edge_node[e]);
+        if (cost == w->sent[e]) continue;
+        w->sent[e] = cost;
+        send_message(w, e, cost);
+        sent++;
+    }
+    return sent;
+}
+
+// 노드 u 의 다음 전송 시각 (지금 이후로 (t + 노드별 위상) 이 간격의 배수인 첫 시각) 에 갱신을 보내도록 예약
+static void schedule_flush(SimWorker *w, int u) {
+    if (w->flush_pending[u]) return;
+    w->flush_pending[u] = 1;
+    uint32_t phase = (uint32_t)u * 2654435761u % (uint32_t)update_interval; // 노드마다 흩어 놓음
+    uint32_t wait = (uint32_t)update_interval - (w->wheel.now + phase) % (uint32_t)update_interval;
+    add_event(w, w->wheel.now + wait % (uint32_t)update_interval, -1 - u, 0);
+}
+
+// 노드 u 의 다음 홉을 따라가 u 로 돌아오면 루프로 기록
+static void check_loop(SimWorker *w, int u) {
+    int stamp = ++w->stamp;
+    w->mark[u] = stamp;
+    int length = 1;
+    for (int x = w->hop[u]; x != NOT_EXIST && x != w->destination; x = w->hop[x]) {
+        if (x == u) { // u 를 지나는 루프
+            w->current->loops++;
+            if (length > w->current->longest_loop) w->current->longest_loop = length;
+            return;
+        }
+        if (w->mark[x] == stamp) return; // u 와 무관한 루프로 들어감 (그 루프가 생길 때 기록함)
+        w->mark[x] = stamp;
+        length++;
+    }
+}
+
+// 이웃들이 알린 비용으로 노드 u 의 경로를 다시 계산하고, 바뀌었으면 이웃에게 알림
+// 지금 다음 홉이 여전히 최소 비용이면 그대로 두고, 아니면 최소 비용을 내는 가장 작은 이웃을 고른다 (distvec -w 와 같음).
+static void recompute(SimWorker *w, int u) {
+    if (u == w->destination) return;
+    int best_cost = route_infinity;
+    int best_hop = NOT_EXIST;
+    for (int e = edge_start[u]; e < edge_start[u + 1]; e++) {
+        if (w->edge_cost[e] >= INFINITY_COST) continue;
+        int cost = w->edge_cost[e] + w->received[e];
+        if (cost < best_cost || (cost == best_cost && cost < route_infinity && edge_node[e] == w->hop[u])) {
+            best_cost = cost;
+            best_hop = edge_node[e];
+        }
+    }
+    if (best_cost >= route_infinity) {
+        best_cost = route_infinity;
+        best_hop = NOT_EXIST;
+    }
+    if (best_cost == w->dist[u] && best_hop == w->hop[u]) return;
+    int hop_changed = best_hop != w->hop[u];
+    w->dist[u] = best_cost;
+    w->hop[u] = best_hop;
+    w->current->route_changes++;
+    if (hop_changed && best_hop != NOT_EXIST) check_loop(w, u);
+    schedule_flush(w, u);
+}
+
+// 이벤트가 없을 때까지 처리하고 수렴 시간 (마지막 메시지 도착이나 전송) 을 기록
+static void run_events(SimWorker *w) {
+    uint32_t start = w->wheel.now, last = start, t;
+    int event;
+    while ((event = timer_wheel_pop(&w->wheel, &t)) >= 0) {
+        int e = w->event_edge[event];
+        int cost = w->event_cost[event];
+        timer_wheel_release(&w->wheel, event);
+        if (e < 0) { // 전송 시각: 그동안 바뀐 값을 모아서 보냄
+            w->flush_pending[-1 - e] = 0;
+            if (advertise(w, -1 - e)) last = t;
+            continue;
+        }
+        last = t;
+        if (w->edge_cost[e] >= INFINITY_COST) continue; // 오는 중에 링크가 끊김
+        w->received[e] = cost < route_infinity ? cost : route_infinity;
+        recompute(w, edge_node[edge_reverse[e]]);
+    }
+    if (last - start > w->current->converge_time) w->current->converge_time = last - start;
+}
+
+static inline void bucket_insert(SimWorker *w, int node) {
+    int *head = &w->bucket[w->dist[node] % INFINITY_COST];
+    w->bucket_prev[node] = NOT_EXIST;
+    w->bucket_next[node] = *head;
+    if (*head != NOT_EXIST) w->bucket_prev[*head] = node;
+    *head = node;
+}
+
+static inline void bucket_remove(SimWorker *w, int node) {
+    int prev = w->bucket_prev[node], next = w->bucket_next[node];
+    if (prev != NOT_EXIST) {
+        w->bucket_next[prev] = next;
+    } else {
+        w->bucket[w->dist[node] % INFINITY_COST] = next;
+    }
+    if (next != NOT_EXIST) w->bucket_prev[next] = prev;
+}
+
+// 처음 토폴로지에서 수렴한 상태로 시작 (다익스트라로 비용, 가장 작은 최소 비용 이웃을 다음 홉으로)
+// 링크 비용이 1 ~ INFINITY_COST - 1 의 정수라 힙 대신 비용별 버킷을 차례로 비운다 (Dial).
+// 아직 확정되지 않은 노드의 비용은 지금 비용부터 INFINITY_COST - 1 안이라 버킷을 원형으로 쓸 수 있다.
+static void start_converged(SimWorker *w) {
+    int d = w->destination;
+    for (int i = 0; i < node_count; i++) w->dist[i] = INT_MAX;
+    for (int i = 0; i < INFINITY_COST; i++) w->bucket[i] = NOT_EXIST;
+    w->dist[d] = 0;
+    bucket_insert(w, d);
+    int waiting = 1; // 버킷에 든 노드 수
+    for (int current = 0; waiting > 0; current++) {
+        int u;
+        while ((u = w->bucket[current % INFINITY_COST]) != NOT_EXIST) { // 비용이 current 인 노드를 확정
+            bucket_remove(w, u);
+            waiting--;
+            for (int e = edge_start[u]; e < edge_start[u + 1]; e++) {
+                if (w->edge_cost[e] >= INFINITY_COST) continue;
+                int v = edge_node[e];
+                int cost = current + w->edge_cost[e];
+                if (cost >= route_infinity || cost >= w->dist[v]) continue;
+                if (w->dist[v] != INT_MAX) {
+                    bucket_remove(w, v); // 더 싼 경로: 버킷을 옮김
+                } else {
+                    waiting++;
+                }
+                w->dist[v] = cost;
+                bucket_insert(w, v);
+            }
+        }
+    }
+    for (int u = 0; u < node_count; u++) {
+        w->hop[u] = NOT_EXIST;
+        w->flush_pending[u] = 0;
+        if (w->dist[u] == INT_MAX) w->dist[u] = route_infinity;
+    }
+    w->hop[d] = d;
+    for (int u = 0; u < node_count; u++) {
+        if (u == d || w->dist[u] >= route_infinity) continue;
+        for (int e = edge_start[u]; e < edge_start[u + 1]; e++) { // 이웃은 번호 순
+            if (w->edge_cost[e] < INFINITY_COST && w->edge_cost[e] + w->dist[edge_node[e]] == w->dist[u]) {
+                w->hop[u] = edge_node[e];
+                break;
+            }
+        }
+    }
+    for (int u = 0; u < node_count; u++) { // 이웃끼리 이미 주고받은 값
+        for (int e = edge_start[u]; e < edge_start[u + 1]; e++) {
+            if (w->edge_cost[e] >= INFINITY_COST) {
+                w->received[e] = route_infinity;
+                w->sent[e] = UNSENT;
+            } else {
+                w->received[e] = advertised_cost(w, edge_node[e], u);
+                w->sent[e] = advertised_cost(w, u, edge_node[e]);
+            }
+        }
+    }
+}
+
+// 모든 노드가 빈 벡터로 시작 (목적지만 비용 0 을 이웃에게 알림)
+static void start_cold(SimWorker *w) {
+    int d = w->destination;
+    for (int u = 0; u < node_count; u++) {
+        w->dist[u] = route_infinity;
+        w->hop[u] = NOT_EXIST;
+        w->flush_pending[u] = 0;
+    }
+    w->dist[d] = 0;
+    w->hop[d] = d;
+    for (int e = 0; e < edge_count; e++) {
+        w->received[e] = route_infinity;
+        w->sent[e] = route_infinity; // 도달할 수 없음은 알리지 않아도 같음
+    }
+    schedule_flush(w, d);
+}
+
+// 변경 하나: 양 끝 노드가 바로 알아채고 경로를 다시 계산, 새로 이어진 링크로는 서로 지금 값을 보냄
+static void apply_change(SimWorker *w, const Change *change) {
+    int e = change->edge;
+    if (e == NOT_EXIST || w->edge_cost[e] == change->pair_cost) return;
+    int reverse = edge_reverse[e];
+    int was_up = w->edge_cost[e] < INFINITY_COST;
+    w->edge_cost[e] = w->edge_cost[reverse] = change->pair_cost;
+    if (change->pair_cost >= INFINITY_COST || !was_up) { // 끊기거나 새로 이어짐: 주고받은 값을 잊음
+        w->received[e] = w->received[reverse] = route_infinity;
+        w->sent[e] = w->sent[reverse] = UNSENT;
+    }
+    recompute(w, change->source);
+    recompute(w, change->destination);
+    schedule_flush(w, change->source); // 경로가 그대로여도 새 이웃에게는 보냄
+    schedule_flush(w, change->destination);
+    run_events(w);
+}
+
+// 목적지 하나의 처음 수렴과 모든 변경을 시뮬레이션 (steal_pool 작업)
+void simulate_destination(void *ctx, int worker, int index) {
+    (void)ctx;
+    SimWorker *w = &workers[worker];
+    w->destination = sample_destination[index];
+    memcpy(w->edge_cost, initial_cost, sizeof(int) * edge_count);
+    timer_wheel_reset(&w->wheel);
+    w->current = &w->phase[0];
+    if (cold_start) {
+        start_cold(w);
+        run_events(w);
+    } else {
+        start_converged(w);
+    }
+    for (int c = 0; c < change_count; c++) {
+        w->current = &w->phase[c + 1];
+        apply_change(w, &change_table[c]);
+    }
+}
+
+static void print_phase(const PhaseStats *stats) {
+    printf("converged in %u ticks, %lld messages, %lld route changes, %lld loops", stats->converge_time,
+           stats->messages, stats->route_changes, stats->loops);
+    if (stats->loops) printf(" (longest %d)", stats->longest_loop);
+    printf("\n");
+}
+
+void print_report(int samples, double seconds) {
+    PhaseStats *total = (PhaseStats *)calloc(change_count + 1, sizeof(PhaseStats));
+    if (total == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    int threads = sim_threads < samples ? sim_threads : samples;
+    for (int t = 0; t < threads; t++) { // 스레드별 누적을 합침 (합과 최댓값이라 나눈 방식과 무관)
+        for (int p = 0; p <= change_count; p++) {
+            PhaseStats *from = &workers[t].phase[p];
+            PhaseStats *to = &total[p];
+            if (from->converge_time > to->converge_time) to->converge_time = from->converge_time;
+            to->messages += from->messages;
+            to->route_changes += from->route_changes;
+            to->loops += from->loops;
+            if (from->longest_loop > to->longest_loop) to->longest_loop = from->longest_loop;
+        }
+    }
+
+    printf("dvsim: %d nodes, %d node pairs, %d of %d destinations, ", node_count, edge_count / 2, samples, node_count);
+    if (delay_by_cost) {
+        printf("link delay = cost");
+    } else {
+        printf("link delay %d", link_delay);
+    }
+    printf(", update interval %d", update_interval);
+    printf(", infinity %d%s\n", route_infinity, poison_reverse ? ", poison reverse" : "");
+    printf("initial: ");
+    if (cold_start) {
+        print_phase(&total[0]);
+    } else {
+        printf("started converged\n");
+    }
+    for (int c = 0; c < change_count; c++) {
+        printf("change %d %d %d: ", change_table[c].source, change_table[c].destination, change_table[c].cost);
+        print_phase(&total[c + 1]);
+    }
+    printf("simulated in %.2f s\n", seconds);
+    free(total);
+}
+
+int main(int argc, char **argv) {
+    if (initialize(argc, argv) == -1) { // 초기화 실패 시 종료
+        return -1;
+    }
+
+    read_topology(); // 토폴로지 읽기
+    Link *initial_links = (Link *)allocate(sizeof(Link) * link_count);
+    memcpy(initial_links, link_table, sizeof(Link) * link_count);
+    int initial_count = link_count;
+    read_changes(); // 변경을 링크 테이블에 미리 반영
+    build_edges(initial_links, initial_count);
+    free(initial_links);
+
+    int samples = sample_count < 0 ? (node_count > DEFAULT_SAMPLE ? DEFAULT_SAMPLE : node_count)
+                                   : (sample_count == 0 || sample_count > node_count ? node_count : sample_count);
+    sample_destination = (int *)allocate(sizeof(int) * samples);
+    for (int i = 0; i < samples; i++) sample_destination[i] = (int)((long long)i * node_count / samples); // 고르게
+
+    int threads = sim_threads < samples ? sim_threads : samples;
+    if (threads < 1) threads = 1;
+    workers = (SimWorker *)calloc(threads, sizeof(SimWorker));
+    if (workers == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    for (int t = 0; t < threads; t++) init_worker(&workers[t]);
+
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    steal_pool_run(threads, samples, simulate_destination, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    print_report(samples, (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) * 1e-9);
+
+    for (int t = 0; t < threads; t++) free_worker(&workers[t]);
+    free(workers);
+    free(sample_destination);
+    fclose(topology_file);
+    if (change_file) fclose(change_file);
+    free(link_table);
+    free(change_table);
+    free(edge_start);
+    free(edge_node);
+    free(edge_reverse);
+    free(initial_cost);
+
+    return 0; // 프로그램 종료
+}
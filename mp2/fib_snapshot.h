@@ -0,0 +1,196 @@
+#ifndef FIB_SNAPSHOT_H
+#define FIB_SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include "routing_store.h"
+#include "buffered_writer.h"
+
+// 라우팅 테이블 바이너리 스냅숏 (linkstate / distvec -b, fibdump)
+//
+// 스냅숏 하나는 64 바이트 헤더 뒤에 비용 배열과 다음 홉 배열을 RoutingStore 와 같은 모양
+// (node_count x node_count 행 우선, 출발지 행이 연속, 폭은 헤더에 적힘) 으로 둔다.
+// 배열은 64 바이트, 스냅숏 전체는 4096 바이트 단위로 맞춰 파일에 이어 붙이므로,
+// 읽는 쪽은 파일을 mmap 해 헤더의 size 만큼씩 건너뛰며 배열을 그대로 쓴다 (파싱 없음).
+// 쓸 때는 헤더, 두 배열, 채움 바이트를 writev 한 번으로 보낸다.
+// 값은 쓴 기계의 바이트 순서이고, 읽는 쪽은 endian 칸으로 같은지 확인한다.
+// 텍스트 라우팅 테이블 (output_*.txt 의 형식) 은 routing_store_write_text 로 어느 쪽에서든 만든다.
+
+#define FIB_MAGIC "MP2FIB\0\0"
+#define FIB_VERSION 1
+#define FIB_ENDIAN 0x01020304u
+#define FIB_ARRAY_ALIGN 64
+#define FIB_SNAPSHOT_ALIGN 4096
+
+typedef struct {
+    char magic[8];         // FIB_MAGIC
+    uint32_t version;      // FIB_VERSION
+    uint32_t header_size;  // sizeof(FibHeader)
+    uint32_t endian;       // 쓴 기계의 바이트 순서로 적은 FIB_ENDIAN
+    uint32_t node_count;
+    uint32_t cost_width;   // 비용 한 칸의 바이트 수 (2, 4)
+    uint32_t hop_width;    // 다음 홉 한 칸의 바이트 수 (1, 2, 4)
+    uint32_t sequence;     // 0 은 처음 테이블, k 는 k 번째 변경 뒤 테이블
+    uint32_t infinity;     // 도달할 수 없는 칸의 비용
+    uint64_t cost_offset;  // 스냅숏 시작에서 비용 배열까지
+    uint64_t hop_offset;   // 스냅숏 시작에서 다음 홉 배열까지
+    uint64_t size;         // 채움 바이트를 포함한 스냅숏 크기 (다음 스냅숏 위치)
+} FibHeader;
+
+typedef struct {
+    const char *data; // mmap 한 파일
+    size_t size;
+} FibFile;
+
+static inline uint64_t fib_align(uint64_t value, uint64_t align)
+{
+    return (value + align - 1) / align * align;
+}
+
+// 스냅숏 하나를 fd 에 씀
+static inline void fib_snapshot_write(int fd, const RoutingStore *store, uint32_t sequence, int infinity)
+{
+    static const char zeros[FIB_SNAPSHOT_ALIGN] = {0};
+    uint64_t cells = (uint64_t)store->node_count * store->node_count;
+    FibHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FIB_MAGIC, sizeof(header.magic));
+    header.version = FIB_VERSION;
+    header.header_size = sizeof(FibHeader);
+    header.endian = FIB_ENDIAN;
+    header.node_count = (uint32_t)store->node_count;
+    header.cost_width = (uint32_t)store->cost_width;
+    header.hop_width = (uint32_t)store->hop_width;
+    header.sequence = sequence;
+    header.infinity = (uint32_t)infinity;
+    header.cost_offset = fib_align(sizeof(FibHeader), FIB_ARRAY_ALIGN);
+    header.hop_offset = fib_align(header.cost_offset + cells * header.cost_width, FIB_ARRAY_ALIGN);
+    header.size = fib_align(header.hop_offset + cells * header.hop_width, FIB_SNAPSHOT_ALIGN);
+
+    struct iovec iov[6] = {
+        {&header, sizeof(header)},
+        {(void *)zeros, (size_t)(header.cost_offset - sizeof(header))},
+        {store->cost, (size_t)(cells * header.cost_width)},
+        {(void *)zeros, (size_t)(header.hop_offset - header.cost_offset - cells * header.cost_width)},
+        {store->next_hop, (size_t)(cells * header.hop_width)},
+        {(void *)zeros, (size_t)(header.size - header.hop_offset - cells * header.hop_width)},
+    };
+    struct iovec *left = iov;
+    int count = 6;
+    while (count > 0) { // 보통 한 번에 끝나고, 일부만 쓰였으면 남은 부분부터 다시 씀
+        ssize_t written = writev(fd, left, count);
+        if (written < 0) {
+            printf("Error: write snapshot file.\n");
+            exit(1);
+        }
+        while (count > 0 && (size_t)written >= left->iov_len) {
+            written -= left->iov_len;
+            left++;
+            count--;
+        }
+        if (count > 0) {
+            left->iov_base = (char *)left->iov_base + written;
+            left->iov_len -= written;
+        }
+    }
+}
+
+// 스냅숏 파일을 읽기 전용으로 mmap (실패하면 -1)
+static inline int fib_file_open(FibFile *file, const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    file->size = (size_t)st.st_size;
+    file->data = NULL;
+    if (file->size > 0) {
+        void *data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        file->data = (const char *)data;
+    }
+    close(fd);
+    return 0;
+}
+
+static inline void fib_file_close(FibFile *file)
+{
+    if (file->data) munmap((void *)file->data, file->size);
+    file->data = NULL;
+}
+
+// offset 의 스냅숏 헤더를 검사하고 배열을 가리키는 RoutingStore 를 채움
+// 다음 스냅숏 위치를 반환 (파일 끝이면 0, 잘못된 스냅숏이면 -1)
+// 크기 검사는 모두 파일의 남은 크기 안에서 빼기와 나누기로 해 헤더 값이 커도 넘치지 않는다.
+static inline int64_t fib_file_snapshot(const FibFile *file, uint64_t offset, FibHeader *header, RoutingStore *view)
+{
+    if (offset >= file->size) return 0;
+    if (file->size - offset < sizeof(FibHeader)) return -1;
+    memcpy(header, file->data + offset, sizeof(FibHeader));
+    if (memcmp(header->magic, FIB_MAGIC, sizeof(header->magic)) != 0 || header->version != FIB_VERSION ||
+        header->header_size != sizeof(FibHeader) || header->endian != FIB_ENDIAN)
+        return -1;
+    if ((header->cost_width != 2 && header->cost_width != 4) ||
+        (header->hop_width != 1 && header->hop_width != 2 && header->hop_width != 4))
+        return -1;
+    if (header->node_count > INT_MAX) return -1;
+    uint64_t cells = (uint64_t)header->node_count * header->node_count; // 2^62 보다 작음
+    uint64_t size = header->size;
+    if (size > file->size - offset) return -1;
+    if (cells > size / header->cost_width || cells > size / header->hop_width) return -1;
+    uint64_t cost_bytes = cells * header->cost_width, hop_bytes = cells * header->hop_width;
+    if (header->cost_offset < sizeof(FibHeader) || header->cost_offset > size || cost_bytes > size - header->cost_offset)
+        return -1;
+    if (header->hop_offset < header->cost_offset + cost_bytes || header->hop_offset > size || hop_bytes > size - header->hop_offset)
+        return -1;
+    view->node_count = (int)header->node_count;
+    view->cost_width = (int)header->cost_width;
+    view->hop_width = (int)header->hop_width;
+    view->cost = (void *)(file->data + offset + header->cost_offset); // 읽기만 함
+    view->next_hop = (void *)(file->data + offset + header->hop_offset);
+    return (int64_t)(offset + header->size);
+}
+
+template <typename C, typename H>
+static void routing_text_rows(const RoutingStore *store, BufferedWriter *writer, int infinity)
+{
+    const C *cost = (const C *)store->cost;
+    const H *next_hop = (const H *)store->next_hop;
+    size_t n = (size_t)store->node_count;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            if (cost[i * n + j] == infinity) continue;
+            byte_buffer_put_int(&writer->buffer, (int)j);
+            byte_buffer_put_char(&writer->buffer, ' ');
+            byte_buffer_put_int(&writer->buffer, next_hop[i * n + j]);
+            byte_buffer_put_char(&writer->buffer, ' ');
+            byte_buffer_put_int(&writer->buffer, cost[i * n + j]);
+            byte_buffer_put_char(&writer->buffer, '\n');
+        }
+        byte_buffer_put_char(&writer->buffer, '\n');
+        writer_maybe_flush(writer);
+    }
+}
+
+// 텍스트 라우팅 테이블: 출발지 행마다 "목적지 다음홉 비용" 줄 (비용이 infinity 인 칸 제외) 과 빈 줄
+static inline void routing_store_write_text(const RoutingStore *store, BufferedWriter *writer, int infinity)
+{
+    ROUTING_STORE_DISPATCH(store, routing_text_rows, store, writer, infinity);
+}
+
+#endif
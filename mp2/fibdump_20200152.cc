@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "routing_store.h"
+#include "buffered_writer.h"
+#include "fib_snapshot.h"
+
+// 바이너리 라우팅 테이블 스냅숏 (linkstate / distvec -b 의 output_*.fib) 을 텍스트로 출력
+//
+// 파일을 mmap 해 스냅숏마다 output_*.txt 와 같은 형식의 라우팅 테이블을 표준 출력에 쓴다.
+// -s 로 스냅숏 번호 (0 은 처음 테이블, k 는 k 번째 변경 뒤) 하나만 고를 수 있고,
+// -i 는 테이블 대신 스냅숏마다 헤더 정보를 한 줄씩 쓴다.
+
+int main(int argc, char **argv) {
+    int opt;
+    int only = -1; // -s: 출력할 스냅숏 번호 (-1 이면 모두)
+    int info = 0; // -i: 헤더 정보만 출력
+    int usage = 0;
+    while ((opt = getopt(argc, argv, "s:i")) != -1) {
+        if (opt == 's' && atoi(optarg) >= 0) {
+            only = atoi(optarg);
+        } else if (opt == 'i') {
+            info = 1;
+        } else {
+            usage = 1;
+        }
+    }
+    if (usage || argc - optind != 1) {
+        printf("usage: fibdump [-s sequence] [-i] fibfile\n");
+        return -1;
+    }
+
+    FibFile file;
+    if (fib_file_open(&file, argv[optind]) != 0) {
+        printf("Error: open input file %s.\n", argv[optind]);
+        return -1;
+    }
+
+    BufferedWriter writer;
+    writer_init(&writer, stdout);
+    uint64_t offset = 0;
+    while (1) {
+        FibHeader header;
+        RoutingStore view;
+        int64_t next = fib_file_snapshot(&file, offset, &header, &view);
+        if (next == 0) break;
+        if (next < 0) {
+            writer_flush(&writer);
+            printf("Error: invalid snapshot at offset %llu.\n", (unsigned long long)offset);
+            return -1;
+        }
+        if (only < 0 || header.sequence == (uint32_t)only) {
+            if (info) {
+                char line[256];
+                int length = snprintf(line, sizeof(line), "snapshot %u offset %llu nodes %u cost %u bytes hop %u bytes size %llu\n",
+                                      header.sequence, (unsigned long long)offset, header.node_count, header.cost_width,
+                                      header.hop_width, (unsigned long long)header.size);
+                byte_buffer_put(&writer.buffer, line, (size_t)length);
+            } else {
+                routing_store_write_text(&view, &writer, (int)header.infinity);
+            }
+        }
+        offset = (uint64_t)next;
+    }
+
+    writer_free(&writer);
+    fib_file_close(&file);
+    return 0; // 프로그램 종료
+}
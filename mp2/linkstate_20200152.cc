@@ -1,16 +1,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+
+#include "routing_store.h"
+#include "steal_pool.h"
+#include "message_batch.h"
+#include "fib_snapshot.h"
 
-#define MAX_NODES 100 // 최대 노드 수를 정의
 #define NOT_EXIST -1 // 존재하지 않음을 나타내는 상수
 #define INFINITY_COST 999 // 무한 비용을 나타내는 상수
-#define MAX_MESSAGE_LENGTH 1000 // 최대 메시지 길이를 정의
 
 FILE *topology_file; // 토폴로지 파일 포인터
 FILE *message_file; // 메시지 파일 포인터
 FILE *change_file; // 변경 파일 포인터
 FILE *output_file; // 출력 파일 포인터
+MessageBatch messages; // 메시지 파일 내용 (처음에 한 번만 읽음)
+BufferedWriter writer; // output_file 출력 버퍼 (라우팅 테이블, 메시지)
+int snapshot_file = -1; // -b: 라우팅 테이블을 텍스트 대신 쓸 바이너리 스냅숏 파일 (없으면 -1)
+uint32_t snapshot_sequence; // 다음에 쓸 스냅숏 번호
 
 typedef struct {
     int source; // 링크의 출발 노드
@@ -18,36 +26,74 @@ typedef struct {
     int cost; // 링크의 비용
 } Link;
 
-typedef struct {
-    int next_hop; // 다음 홉
-    int cost; // 비용
-    int past; // 이전 노드를 저장하는 변수
-} Route;
-
-Link link_table[MAX_NODES]; // 링크 정보를 저장할 테이블
+Link *link_table; // 링크 정보를 저장할 테이블
 int link_count = 0; // 링크 개수
+int link_capacity = 0; // 링크 테이블 크기
 int node_count; // 노드 개수
 
-Route routing_table[MAX_NODES][MAX_NODES]; // 라우팅 테이블
+RoutingStore routing_table; // 라우팅 테이블 (비용, 다음 홉)
 
 #define UNVISITED 0 // 방문하지 않음을 나타내는 상수
 #define VISITED 1 // 방문했음을 나타내는 상수
-short visit_status[MAX_NODES][MAX_NODES]; // 방문 상태를 저장할 배열
+
+// 희소 SPF 용 인접 리스트 (CSR): 노드 i 의 이웃은 adjacency_node[adjacency_start[i] .. adjacency_start[i + 1])
+int *adjacency_start;
+int *adjacency_node;
+int *adjacency_cost;
+int sparse_usable; // 모든 링크 비용이 1 ~ INFINITY_COST 이면 1 (아니면 기존 방식으로 계산)
+
+// 출발지 하나의 SPF 작업 공간
+typedef struct {
+    int *past;      // 기존 방식: 이전 노드
+    char *visited;  // 기존 방식: 방문 상태
+    int *cost;      // 출발지에서의 비용 (아직 닿지 않았으면 INT_MAX)
+    int *ancestor;  // 최단 경로 위 조상 중 가장 작은 번호 (출발지 제외, 없으면 INT_MAX)
+    int *pred;      // 최단 경로의 직전 노드 중 가장 작은 번호
+    char *direct;   // 출발지와 바로 이어진 링크가 최단 경로인지
+    int *heap;      // (비용, 노드 번호) 순 인덱스 이진 힙
+    int *heap_pos;  // 노드의 힙 위치 (-1 이면 힙에 없음)
+    int heap_size;
+} SpfScratch;
+
+SpfScratch spf_scratch; // 기존 방식과 단일 스레드용
+SpfScratch *worker_scratch; // 스레드별 작업 공간 (희소 SPF 병렬 계산)
+int spf_threads; // SPF 작업 스레드 수 (-j, 기본은 CPU 수)
 
 int initialize(int argc, char **argv); // 초기화 함수 선언
+void add_link(int source, int destination, int cost); // 링크 추가 함수 선언
 void read_topology(); // 토폴로지 파일 읽기 함수 선언
 void initialize_routing_table(); // 라우팅 테이블 초기화 함수 선언
 int find_min_cost_unvisited_node(int source); // 최소 비용의 방문하지 않은 노드 찾기 함수 선언
 void update_routes_by_chosen_node(int source, int chosen); // 선택된 노드에 의해 경로 업데이트 함수 선언
+void build_adjacency(); // 링크 테이블로 인접 리스트 생성 함수 선언
+void run_sparse_dijkstra(int source, SpfScratch *scratch); // 희소 다익스트라 함수 선언
 void run_dijkstra(int source); // 다익스트라 알고리즘 실행 함수 선언
+void run_sources(const int *sources, int count); // 여러 출발지의 다익스트라 실행 함수 선언
 void print_routing_table(); // 라우팅 테이블 출력 함수 선언
 void process_messages(); // 메시지 처리 함수 선언
 void update_link_cost(int source, int destination, int new_cost); // 링크 비용 업데이트 함수 선언
+int link_pair_cost(int a, int b, int *cost); // 노드 쌍의 실제 링크 비용 함수 선언
+int update_routes_incrementally(int a, int b, int old_found, int old_cost, int new_found, int new_cost); // 바뀐 링크의 영향만 다시 계산하는 함수 선언
 void apply_changes(); // 변경 사항 적용 함수 선언
 
 int initialize(int argc, char **argv) {
+    int opt;
+    int binary = 0; // -b: 라우팅 테이블을 output_ls.fib 에 바이너리 스냅숏으로 씀
+    spf_threads = steal_pool_cpus(); // 기본은 모든 코어 사용
+    while ((opt = getopt(argc, argv, "j:b")) != -1) {
+        if (opt == 'j' && atoi(optarg) > 0) {
+            spf_threads = atoi(optarg);
+        } else if (opt == 'b') {
+            binary = 1;
+        } else {
+            printf("usage: linkstate [-j threads] [-b] topologyfile messagesfile changesfile\n");
+            return -1;
+        }
+    }
+    argc -= optind - 1; // 옵션을 건너뛴 파일 인자
+    argv += optind - 1;
     if (argc != 4) { // 인자 개수가 올바른지 확인
-        printf("usage: linkstate topologyfile messagesfile changesfile\n");
+        printf("usage: linkstate [-j threads] [-b] topologyfile messagesfile changesfile\n");
         return -1;
     }
 
@@ -74,29 +120,65 @@ int initialize(int argc, char **argv) {
         return -1;
     }
 
+    if (binary) {
+        snapshot_file = open("output_ls.fib", O_WRONLY | O_CREAT | O_TRUNC, 0644); // 스냅숏 파일 열기
+        if (snapshot_file < 0) {
+            printf("Error: open output file output_ls.fib.\n");
+            return -1;
+        }
+    }
+
     return 0; // 초기화 성공
 }
 
+void *allocate(size_t size) {
+    void *p = malloc(size ? size : 1);
+    if (p == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    return p;
+}
+
+// 링크 테이블 끝에 링크 추가 (노드 번호가 범위를 벗어난 링크는 무시)
+void add_link(int source, int destination, int cost) {
+    if (source < 0 || source >= node_count || destination < 0 || destination >= node_count) return;
+    if (link_count == link_capacity) {
+        link_capacity = link_capacity ? link_capacity * 2 : 256;
+        link_table = (Link *)realloc(link_table, sizeof(Link) * link_capacity);
+        if (link_table == NULL) {
+            printf("Error: out of memory.\n");
+            exit(1);
+        }
+    }
+    link_table[link_count].source = source;
+    link_table[link_count].destination = destination;
+    link_table[link_count].cost = cost;
+    link_count++; // 링크 수 증가
+}
+
 void read_topology() {
-    fscanf(topology_file, "%d", &node_count); // 노드 수 읽기
-    while (fscanf(topology_file, "%d %d %d", &link_table[link_count].source, &link_table[link_count].destination, &link_table[link_count].cost) == 3) {
-        link_count++; // 링크 수 증가 및 다음 링크로 이동
+    int source, destination, cost;
+    if (fscanf(topology_file, "%d", &node_count) != 1 || node_count < 0) node_count = 0; // 노드 수 읽기
+    while (fscanf(topology_file, "%d %d %d", &source, &destination, &cost) == 3) {
+        add_link(source, destination, cost);
     }
 }
 
 void initialize_routing_table() {
+    int min_cost = 0, max_cost = INFINITY_COST; // 저장소 비용 폭을 정할 링크 비용 범위
+    for (int i = 0; i < link_count; i++) {
+        if (link_table[i].cost < min_cost) min_cost = link_table[i].cost;
+        if (link_table[i].cost > max_cost) max_cost = link_table[i].cost;
+    }
+    routing_store_prepare(&routing_table, node_count, min_cost, max_cost);
+
     for (int i = 0; i < node_count; i++) {
         for (int j = 0; j < node_count; j++) {
             if (i == j) {
-                routing_table[i][j].cost = 0; // 자기 자신으로의 비용은 0
-                routing_table[i][j].next_hop = i; // 자기 자신을 다음 홉으로 설정
-                routing_table[i][j].past = i; // 이전 노드를 자기 자신으로 설정
-                visit_status[i][j] = VISITED; // 자기 자신으로의 방문 상태는 VISITED
+                store_set(&routing_table, i, j, 0, i); // 자기 자신으로의 비용은 0, 다음 홉은 자기 자신
             } else {
-                routing_table[i][j].cost = INFINITY_COST; // 초기 비용 설정
-                routing_table[i][j].next_hop = NOT_EXIST; // 초기 다음 홉 설정
-                routing_table[i][j].past = NOT_EXIST; // 초기 이전 노드 설정
-                visit_status[i][j] = UNVISITED; // 초기 방문 상태는 UNVISITED
+                store_set(&routing_table, i, j, INFINITY_COST, NOT_EXIST); // 초기 비용과 다음 홉 설정
             }
         }
     }
@@ -108,12 +190,16 @@ void initialize_routing_table() {
         int cost = link_table[i].cost;
 
         // 링크 비용 및 다음 홉 설정
-        routing_table[source][destination].cost = cost;
-        routing_table[source][destination].next_hop = destination;
-        routing_table[source][destination].past = source;
-        routing_table[destination][source].cost = cost;
-        routing_table[destination][source].next_hop = source;
-        routing_table[destination][source].past = destination;
+        store_set(&routing_table, source, destination, cost, destination);
+        store_set(&routing_table, destination, source, cost, source);
+    }
+}
+
+// 기존 방식의 출발지 행 작업 공간 준비: 이전 노드는 링크가 있으면 출발지, 자기 자신만 방문한 상태
+void init_dense_row(int source, SpfScratch *scratch) {
+    for (int j = 0; j < node_count; j++) {
+        scratch->visited[j] = j == source ? VISITED : UNVISITED;
+        scratch->past[j] = j == source || store_next_hop(&routing_table, source, j) != NOT_EXIST ? source : NOT_EXIST;
     }
 }
 
@@ -121,8 +207,8 @@ int find_min_cost_unvisited_node(int source) {
     int min_cost = INFINITY_COST; // 최소 비용 초기화
     int min_node = -1; // 최소 비용 노드 초기화
     for (int destination = 0; destination < node_count; destination++) {
-        if (visit_status[source][destination] == UNVISITED) { // 방문하지 않은 노드에 대해
-            int cost = routing_table[source][destination].cost; // 현재 노드에서 목적지까지의 비용
+        if (spf_scratch.visited[destination] == UNVISITED) { // 방문하지 않은 노드에 대해
+            int cost = store_cost(&routing_table, source, destination); // 현재 노드에서 목적지까지의 비용
             if (cost < min_cost) { // 최소 비용 노드 찾기
                 min_node = destination;
                 min_cost = cost;
@@ -133,27 +219,210 @@ int find_min_cost_unvisited_node(int source) {
 }
 
 void update_routes_by_chosen_node(int source, int chosen) {
-    visit_status[source][chosen] = VISITED; // 선택된 노드를 방문으로 표시
-    int chosen_cost = routing_table[source][chosen].cost;
+    spf_scratch.visited[chosen] = VISITED; // 선택된 노드를 방문으로 표시
+    int chosen_cost = store_cost(&routing_table, source, chosen);
+    int chosen_next_hop = store_next_hop(&routing_table, source, chosen);
+    int *past = spf_scratch.past;
 
     for (int destination = 0; destination < node_count; destination++) { // 모든 목적지에 대해
-        if (visit_status[source][destination] == UNVISITED) { // 방문하지 않은 노드에 대해
-            int new_cost = chosen_cost + routing_table[chosen][destination].cost; // 새로운 비용 계산
-            Route *current_route = &routing_table[source][destination];
-
-            if (new_cost < current_route->cost) { // 더 낮은 비용이 있으면
-                current_route->cost = new_cost; // 비용 업데이트
-                current_route->next_hop = routing_table[source][chosen].next_hop; // 다음 홉 업데이트
-                current_route->past = chosen; // 이전 노드 업데이트
-            } else if (new_cost == current_route->cost && chosen < current_route->past) { // 비용이 같고 더 작은 홉 값을 선택
-                current_route->next_hop = routing_table[source][chosen].next_hop; // 다음 홉 업데이트
-                current_route->past = chosen; // 이전 노드 업데이트
+        if (spf_scratch.visited[destination] == UNVISITED) { // 방문하지 않은 노드에 대해
+            int new_cost = chosen_cost + store_cost(&routing_table, chosen, destination); // 새로운 비용 계산
+            int current_cost = store_cost(&routing_table, source, destination);
+
+            if (new_cost < current_cost) { // 더 낮은 비용이 있으면
+                store_set(&routing_table, source, destination, new_cost, chosen_next_hop); // 비용과 다음 홉 업데이트
+                past[destination] = chosen; // 이전 노드 업데이트
+            } else if (new_cost == current_cost && chosen < past[destination]) { // 비용이 같고 더 작은 홉 값을 선택
+                store_set(&routing_table, source, destination, current_cost, chosen_next_hop); // 다음 홉 업데이트
+                past[destination] = chosen; // 이전 노드 업데이트
+            }
+        }
+    }
+}
+
+typedef struct {
+    int from;
+    int to;
+    int cost;
+    int order; // 링크 테이블에서의 순서
+} AdjacencyEntry;
+
+int compare_adjacency(const void *a, const void *b) {
+    const AdjacencyEntry *x = (const AdjacencyEntry *)a;
+    const AdjacencyEntry *y = (const AdjacencyEntry *)b;
+    if (x->from != y->from) return x->from < y->from ? -1 : 1;
+    if (x->to != y->to) return x->to < y->to ? -1 : 1;
+    return x->order < y->order ? -1 : x->order > y->order;
+}
+
+void build_adjacency() {
+    // 양방향 항목을 (출발, 도착, 순서) 로 정렬하고 같은 노드 쌍은 마지막 링크만 남김
+    // (initialize_routing_table 이 링크를 차례로 덮어쓰는 것과 같은 규칙)
+    AdjacencyEntry *entries = (AdjacencyEntry *)allocate(sizeof(AdjacencyEntry) * 2 * link_count);
+    int entry_count = 0;
+    for (int i = 0; i < link_count; i++) {
+        Link *link = &link_table[i];
+        if (link->source == link->destination) continue; // 자기 자신으로의 링크는 라우팅 테이블에만 반영
+        entries[entry_count++] = (AdjacencyEntry){link->source, link->destination, link->cost, i};
+        entries[entry_count++] = (AdjacencyEntry){link->destination, link->source, link->cost, i};
+    }
+    qsort(entries, entry_count, sizeof(AdjacencyEntry), compare_adjacency);
+
+    free(adjacency_start);
+    free(adjacency_node);
+    free(adjacency_cost);
+    adjacency_start = (int *)calloc(node_count + 1, sizeof(int));
+    adjacency_node = (int *)allocate(sizeof(int) * entry_count);
+    adjacency_cost = (int *)allocate(sizeof(int) * entry_count);
+    if (adjacency_start == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+
+    // 비용이 1 ~ INFINITY_COST 를 벗어나면 희소 SPF 의 동점 처리 전제가 깨지므로 기존 방식을 씀
+    sparse_usable = 1;
+    int count = 0;
+    for (int i = 0; i < entry_count; i++) {
+        if (i + 1 < entry_count && entries[i + 1].from == entries[i].from && entries[i + 1].to == entries[i].to) continue;
+        if (entries[i].cost < 1 || entries[i].cost > INFINITY_COST) sparse_usable = 0;
+        adjacency_start[entries[i].from + 1]++;
+        adjacency_node[count] = entries[i].to;
+        adjacency_cost[count] = entries[i].cost;
+        count++;
+    }
+    for (int i = 0; i < node_count; i++) adjacency_start[i + 1] += adjacency_start[i];
+    free(entries);
+}
+
+void init_spf_scratch(SpfScratch *scratch) {
+    scratch->past = (int *)allocate(sizeof(int) * node_count);
+    scratch->visited = (char *)allocate(node_count);
+    scratch->cost = (int *)allocate(sizeof(int) * node_count);
+    scratch->ancestor = (int *)allocate(sizeof(int) * node_count);
+    scratch->pred = (int *)allocate(sizeof(int) * node_count);
+    scratch->direct = (char *)allocate(node_count);
+    scratch->heap = (int *)allocate(sizeof(int) * node_count);
+    scratch->heap_pos = (int *)allocate(sizeof(int) * node_count);
+    scratch->heap_size = 0;
+}
+
+void free_spf_scratch(SpfScratch *scratch) {
+    free(scratch->past);
+    free(scratch->visited);
+    free(scratch->cost);
+    free(scratch->ancestor);
+    free(scratch->pred);
+    free(scratch->direct);
+    free(scratch->heap);
+    free(scratch->heap_pos);
+}
+
+// 힙 순서: 비용이 작은 노드, 같으면 번호가 작은 노드 (find_min_cost_unvisited_node 와 같음)
+static inline int heap_before(const SpfScratch *scratch, int a, int b) {
+    return scratch->cost[a] < scratch->cost[b] || (scratch->cost[a] == scratch->cost[b] && a < b);
+}
+
+void heap_sift_up(SpfScratch *scratch, int i) {
+    int node = scratch->heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!heap_before(scratch, node, scratch->heap[parent])) break;
+        scratch->heap[i] = scratch->heap[parent];
+        scratch->heap_pos[scratch->heap[i]] = i;
+        i = parent;
+    }
+    scratch->heap[i] = node;
+    scratch->heap_pos[node] = i;
+}
+
+int heap_pop(SpfScratch *scratch) {
+    int top = scratch->heap[0];
+    int node = scratch->heap[--scratch->heap_size];
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= scratch->heap_size) break;
+        if (child + 1 < scratch->heap_size && heap_before(scratch, scratch->heap[child + 1], scratch->heap[child])) child++;
+        if (!heap_before(scratch, scratch->heap[child], node)) break;
+        scratch->heap[i] = scratch->heap[child];
+        scratch->heap_pos[scratch->heap[i]] = i;
+        i = child;
+    }
+    if (scratch->heap_size > 0) {
+        scratch->heap[i] = node;
+        scratch->heap_pos[node] = i;
+    }
+    scratch->heap_pos[top] = -1;
+    return top;
+}
+
+// 인접 리스트와 힙으로 출발지 하나의 라우팅 테이블 행을 계산 (initialize_routing_table 이 끝난 행에 기록)
+//
+// 기존 방식은 선택한 노드의 라우팅 테이블 행으로 갱신한다. 번호가 출발지보다 작은 노드의 행은
+// 이미 최단 비용이 들어 있으므로, 그 노드가 최단 경로 위 어디에 있든 같은 비용의 후보가 되고
+// 동점이면 가장 작은 번호가 past 가 된다. 그래서 결과는 다음과 같다.
+//   1. 최단 경로 위 조상(출발지 제외) 중 출발지보다 작은 번호가 있으면 그 중 가장 작은 노드
+//   2. 없고 출발지와 바로 이어진 링크가 최단 경로면 출발지
+//   3. 아니면 최단 경로의 직전 노드 중 가장 작은 노드
+// 비용이 INFINITY_COST 인 노드는 출발지와 링크(-999 로 끊긴 링크)가 있을 때만 행에 남는다.
+void run_sparse_dijkstra(int source, SpfScratch *scratch) {
+    for (int i = 0; i < node_count; i++) {
+        scratch->cost[i] = INT_MAX;
+        scratch->heap_pos[i] = -1;
+    }
+    scratch->cost[source] = 0;
+    scratch->ancestor[source] = INT_MAX;
+    scratch->heap[0] = source;
+    scratch->heap_pos[source] = 0;
+    scratch->heap_size = 1;
+
+    while (scratch->heap_size > 0) {
+        int chosen = heap_pop(scratch);
+        int chosen_cost = scratch->cost[chosen];
+        if (chosen != source) {
+            if (chosen_cost == INFINITY_COST && !scratch->direct[chosen]) continue; // 도달할 수 없음
+            int next_hop;
+            if (scratch->ancestor[chosen] < source) {
+                next_hop = store_next_hop(&routing_table, source, scratch->ancestor[chosen]);
+            } else if (scratch->direct[chosen]) {
+                next_hop = chosen;
+            } else {
+                next_hop = store_next_hop(&routing_table, source, scratch->pred[chosen]);
+            }
+            store_set(&routing_table, source, chosen, chosen_cost, next_hop);
+            if (chosen_cost == INFINITY_COST) continue; // 이 노드를 거치는 경로는 더 갱신하지 않음
+        }
+
+        int ancestor = chosen == source ? INT_MAX : (scratch->ancestor[chosen] < chosen ? scratch->ancestor[chosen] : chosen);
+        for (int e = adjacency_start[chosen]; e < adjacency_start[chosen + 1]; e++) {
+            int destination = adjacency_node[e];
+            int new_cost = chosen_cost + adjacency_cost[e];
+            if (new_cost > INFINITY_COST) continue;
+            if (new_cost < scratch->cost[destination]) { // 더 낮은 비용
+                scratch->cost[destination] = new_cost;
+                scratch->ancestor[destination] = ancestor;
+                scratch->pred[destination] = chosen;
+                scratch->direct[destination] = chosen == source;
+                if (scratch->heap_pos[destination] < 0) { // 힙 끝에 추가
+                    scratch->heap_pos[destination] = scratch->heap_size;
+                    scratch->heap[scratch->heap_size++] = destination;
+                }
+                heap_sift_up(scratch, scratch->heap_pos[destination]);
+            } else if (new_cost == scratch->cost[destination]) { // 같은 비용의 다른 경로
+                if (ancestor < scratch->ancestor[destination]) scratch->ancestor[destination] = ancestor;
+                if (chosen < scratch->pred[destination]) scratch->pred[destination] = chosen;
+                if (chosen == source) scratch->direct[destination] = 1;
             }
         }
     }
 }
 
 void run_dijkstra(int source) {
+    if (sparse_usable) {
+        run_sparse_dijkstra(source, &spf_scratch);
+        return;
+    }
+    init_dense_row(source, &spf_scratch);
     while (1) {
         int chosen = find_min_cost_unvisited_node(source);
         if (chosen == -1) break; // 더 이상 방문할 노드가 없으면 종료
@@ -161,43 +430,39 @@ void run_dijkstra(int source) {
     }
 }
 
+typedef struct {
+    const int *sources; // 계산할 출발지 목록 (NULL 이면 0 .. count - 1)
+} SourceList;
+
+void run_source_task(void *ctx, int worker, int index) {
+    const SourceList *list = (const SourceList *)ctx;
+    run_sparse_dijkstra(list->sources ? list->sources[index] : index, &worker_scratch[worker]);
+}
+
+// 여러 출발지의 라우팅 테이블 행 계산
+// 희소 SPF 는 출발지 행에만 쓰고 자기 행만 읽으므로 행끼리 독립이라 스레드로 나눠 계산한다.
+// 결과는 계산 순서와 무관해 출력은 단일 스레드와 같다.
+// 기존 방식은 앞 번호 행의 결과로 갱신하므로 차례대로 계산한다.
+void run_sources(const int *sources, int count) {
+    if (!sparse_usable) {
+        for (int i = 0; i < count; i++) run_dijkstra(sources ? sources[i] : i);
+        return;
+    }
+    SourceList list = {sources};
+    steal_pool_run(spf_threads, count, run_source_task, &list);
+}
+
 void print_routing_table() {
-    char buffer[4096]; // 출력 버퍼
-    for (int i = 0; i < node_count; i++) {
-        int offset = 0; // 버퍼 오프셋 초기화
-        for (int j = 0; j < node_count; j++) {
-            if (routing_table[i][j].cost != INFINITY_COST) {
-                offset += snprintf(buffer + offset, sizeof(buffer) - offset, "%d %d %d\n", j, routing_table[i][j].next_hop, routing_table[i][j].cost);
-            }
-        }
-        offset += snprintf(buffer + offset, sizeof(buffer) - offset, "\n");
-        fputs(buffer, output_file); // 버퍼 내용을 출력 파일에 기록
+    if (snapshot_file >= 0) { // -b: 텍스트는 fibdump 로 스냅숏에서 만듦
+        fib_snapshot_write(snapshot_file, &routing_table, snapshot_sequence++, INFINITY_COST);
+        return;
     }
+    routing_store_write_text(&routing_table, &writer, INFINITY_COST);
 }
 
 void process_messages() {
-    rewind(message_file); // 메시지 파일의 처음으로 이동
-    int source, destination;
-    char message[MAX_MESSAGE_LENGTH];
-    char buffer[4096]; // 출력 버퍼
-    while (fscanf(message_file, "%d %d %[^\n]", &source, &destination, message) == 3) {
-        int offset = 0; // 버퍼 오프셋 초기화
-        offset += snprintf(buffer + offset, sizeof(buffer) - offset, "from %d to %d cost ", source, destination);
-        int next = routing_table[source][destination].next_hop; // 다음 홉 가져오기
-        if (next == -1) {
-            offset += snprintf(buffer + offset, sizeof(buffer) - offset, "infinite hops unreachable ");
-        } else {
-            offset += snprintf(buffer + offset, sizeof(buffer) - offset, "%d hops ", routing_table[source][destination].cost);
-            offset += snprintf(buffer + offset, sizeof(buffer) - offset, "%d ", source);
-            while (next != destination) {
-                offset += snprintf(buffer + offset, sizeof(buffer) - offset, "%d ", next);
-                next = routing_table[next][destination].next_hop;
-            }
-        }
-        offset += snprintf(buffer + offset, sizeof(buffer) - offset, "message %s\n", message);
-        fputs(buffer, output_file); // 버퍼 내용을 출력 파일에 기록
-    }
-    fputs("\n", output_file); // 메시지 사이에 빈 줄 삽입
+    message_batch_refresh(&messages, &routing_table); // 다음 홉이나 비용이 바뀐 목적지의 경로만 다시 만듦
+    message_batch_write(&messages, &writer);
 }
 
 void update_link_cost(int source, int destination, int new_cost) {
@@ -213,23 +478,98 @@ void update_link_cost(int source, int destination, int new_cost) {
 
     // 링크를 찾지 못했으면 새로운 링크 추가
     if (new_cost != INFINITY_COST) {
-        link_table[link_count].source = source;
-        link_table[link_count].destination = destination;
-        link_table[link_count].cost = new_cost;
-        link_count++; // 링크 수 증가
+        add_link(source, destination, new_cost);
     }
 }
 
+// 노드 쌍 (a, b) 의 실제 링크 비용을 cost 에 넣고 링크가 있으면 1, 없으면 0 반환
+// 같은 쌍이 여러 번 있으면 마지막 링크 (initialize_routing_table 과 같음). 비용은 -1 (NOT_EXIST) 일 수도 있다.
+int link_pair_cost(int a, int b, int *cost) {
+    for (int i = link_count - 1; i >= 0; i--) {
+        if ((link_table[i].source == a && link_table[i].destination == b) ||
+            (link_table[i].source == b && link_table[i].destination == a)) {
+            *cost = link_table[i].cost;
+            return 1;
+        }
+    }
+    *cost = INFINITY_COST;
+    return 0;
+}
+
+// 인접 리스트에서 a -> b 항목 위치 (없으면 -1)
+int find_adjacency(int a, int b) {
+    for (int e = adjacency_start[a]; e < adjacency_start[a + 1]; e++) {
+        if (adjacency_node[e] == b) return e;
+    }
+    return -1;
+}
+
+// 출발지 행을 initialize_routing_table 직후 상태로 되돌림
+// 희소 SPF 를 쓸 때는 모든 링크 비용이 INFINITY_COST 이하라 링크로 채운 칸은 SPF 가 다시 쓰므로
+// 대각선(자기 자신으로의 링크)만 그대로 두고 나머지를 비우면 된다.
+void reset_row(int source) {
+    for (int j = 0; j < node_count; j++) {
+        if (j != source) store_set(&routing_table, source, j, INFINITY_COST, NOT_EXIST);
+    }
+}
+
+// 노드 쌍 (a, b) 의 링크 비용이 old_cost 에서 new_cost 로 바뀐 뒤 영향을 받는 출발지의 행만 다시 계산
+// (old_found / new_found 가 0 이면 바뀌기 전 / 뒤에 링크가 없음). 희소 SPF 를 쓸 수 없거나 새 비용이 1 ~ INFINITY_COST 를 벗어나면
+// 0 을 반환하고 호출한 쪽이 전체를 다시 계산한다 (저장소 비용 폭도 그때 새 비용에 맞게 다시 고름).
+//
+// 희소 SPF 의 행은 그 출발지의 최단 경로 DAG (최단 비용과 비용이 딱 맞는 링크들) 로만 정해진다.
+// 바뀌기 전 행의 비용으로 보아 바뀐 링크가 DAG 에 있었거나 (비용 증가, 끊김),
+// 바뀐 비용으로 경로가 같아지거나 짧아지는 (비용 감소, 새 링크) 출발지만 DAG 가 달라질 수 있다.
+// 도달할 수 없는 노드의 비용은 INFINITY_COST 라 두 조건 모두 자연스럽게 빠진다.
+int update_routes_incrementally(int a, int b, int old_found, int old_cost, int new_found, int new_cost) {
+    if (!new_found) return 1; // 없던 링크를 끊음 (링크를 추가하지 않음)
+    if (old_found && old_cost == new_cost) return 1; // 실제 링크 비용은 그대로 (같은 쌍의 뒤쪽 링크가 우선하는 경우 포함)
+    if (!sparse_usable) return 0;
+    if (new_cost < 1 || new_cost > INFINITY_COST) return 0;
+    if (a == b) { // 자기 자신으로의 링크는 대각선에만 반영
+        store_set(&routing_table, a, a, new_cost, a);
+        return 1;
+    }
+
+    int *affected = (int *)allocate(sizeof(int) * node_count); // 다시 계산할 출발지 (SPF 전에 기존 행으로 모두 고름)
+    int affected_count = 0;
+    for (int s = 0; s < node_count; s++) {
+        int cost_a = s == a ? 0 : store_cost(&routing_table, s, a);
+        int cost_b = s == b ? 0 : store_cost(&routing_table, s, b);
+        int was_tight = old_found && (cost_a + old_cost == cost_b || cost_b + old_cost == cost_a);
+        int now_tight = cost_a + new_cost <= cost_b || cost_b + new_cost <= cost_a;
+        if (was_tight || now_tight) affected[affected_count++] = s;
+    }
+
+    int ab = find_adjacency(a, b);
+    if (ab >= 0) { // 비용만 바뀜
+        adjacency_cost[ab] = new_cost;
+        adjacency_cost[find_adjacency(b, a)] = new_cost;
+    } else {
+        build_adjacency(); // 새 노드 쌍
+    }
+
+    for (int i = 0; i < affected_count; i++) {
+        reset_row(affected[i]);
+    }
+    run_sources(affected, affected_count);
+    free(affected);
+    return 1;
+}
+
 void apply_changes() {
     if (change_file == NULL) return; // change_file이 NULL인 경우 바로 반환
 
     int source, destination, cost;
     while (fscanf(change_file, "%d %d %d", &source, &destination, &cost) == 3) { // 변경 파일에서 데이터를 읽어옴
+        int old_cost, new_cost;
+        int old_found = link_pair_cost(source, destination, &old_cost);
         update_link_cost(source, destination, cost); // 링크 비용 업데이트
-        initialize_routing_table(); // 라우팅 테이블 초기화
-
-        for (int i = 0; i < node_count; i++) { // 모든 노드에 대해
-            run_dijkstra(i); // 다익스트라 알고리즘 실행
+        int new_found = link_pair_cost(source, destination, &new_cost);
+        if (!update_routes_incrementally(source, destination, old_found, old_cost, new_found, new_cost)) {
+            initialize_routing_table(); // 라우팅 테이블 초기화
+            build_adjacency(); // 인접 리스트 다시 생성
+            run_sources(NULL, node_count); // 모든 노드에 대해 다익스트라 알고리즘 실행
         }
 
         print_routing_table(); // 라우팅 테이블 출력
@@ -241,14 +581,18 @@ int main(int argc, char **argv) {
     if (initialize(argc, argv) == -1) return -1; // 초기화 실패 시 종료
     
     read_topology(); // 토폴로지 읽기
+    message_batch_load(&messages, message_file, node_count); // 메시지 파일 읽기
+    writer_init(&writer, output_file);
     initialize_routing_table(); // 라우팅 테이블 초기화
-    
-    for (int i = 0; i < node_count; i++) { // 모든 노드에 대해
-        run_dijkstra(i); // 다익스트라 알고리즘 실행
-    }
+    build_adjacency(); // 인접 리스트 생성
+    init_spf_scratch(&spf_scratch); // 작업 공간 할당
+    if (spf_threads > node_count) spf_threads = node_count > 0 ? node_count : 1;
+    worker_scratch = (SpfScratch *)allocate(sizeof(SpfScratch) * spf_threads);
+    for (int t = 0; t < spf_threads; t++) init_spf_scratch(&worker_scratch[t]);
+
+    run_sources(NULL, node_count); // 모든 노드에 대해 다익스트라 알고리즘 실행
     print_routing_table(); // 라우팅 테이블 출력
 
-    message_file = fopen(argv[2], "r"); // 메시지 파일 열기
     if (message_file) {
         process_messages(); // 메시지 처리
     }
@@ -257,10 +601,21 @@ int main(int argc, char **argv) {
         apply_changes(); // 변경 사항 적용
     }
 
+    writer_free(&writer);
     fclose(topology_file);
     fclose(message_file);
     if (change_file) fclose(change_file);
     fclose(output_file);
+    if (snapshot_file >= 0) close(snapshot_file);
+    free_spf_scratch(&spf_scratch);
+    for (int t = 0; t < spf_threads; t++) free_spf_scratch(&worker_scratch[t]);
+    free(worker_scratch);
+    free(adjacency_start);
+    free(adjacency_node);
+    free(adjacency_cost);
+    free(link_table);
+    routing_store_free(&routing_table);
+    message_batch_free(&messages);
 
     printf("Complete. Output file written to output_ls.txt.\n");
 
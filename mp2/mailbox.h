@@ -0,0 +1,67 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+// 스레드 사이의 잠금 없는 우편함 (보내는 스레드 하나, 받는 스레드 하나)
+//
+// 고정 크기 원형 버퍼. 보내는 쪽만 tail 을, 받는 쪽만 head 를 바꾸므로 잠금이 필요 없다.
+// tail 을 release 로 올리고 head 를 acquire 로 읽으므로, 받는 쪽은 보내기 전에 쓴 값(라우팅 테이블 칸)을 모두 본다.
+// 가득 차면 mailbox_push 가 넣은 만큼만 반환하므로 나머지는 보내는 쪽이 들고 있다가 다시 보낸다.
+
+typedef struct {
+    uint64_t *items;
+    uint32_t mask; // 크기 - 1 (크기는 2 의 거듭제곱)
+    char pad0[64];
+    uint32_t head; // 받는 쪽: 다음에 꺼낼 위치
+    char pad1[64];
+    uint32_t tail; // 보내는 쪽: 다음에 넣을 위치
+    char pad2[64];
+} Mailbox;
+
+static inline void mailbox_init(Mailbox *box, uint32_t capacity)
+{
+    uint32_t size = 1;
+    while (size < capacity) size <<= 1;
+    box->items = (uint64_t *)malloc(sizeof(uint64_t) * size);
+    if (box->items == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    box->mask = size - 1;
+    box->head = box->tail = 0;
+}
+
+static inline void mailbox_free(Mailbox *box)
+{
+    free(box->items);
+    box->items = NULL;
+}
+
+// items 를 최대 count 개 넣고 넣은 개수 반환 (보내는 스레드만 호출)
+static inline int mailbox_push(Mailbox *box, const uint64_t *items, int count)
+{
+    uint32_t tail = box->tail;
+    uint32_t head = __atomic_load_n(&box->head, __ATOMIC_ACQUIRE);
+    uint32_t room = box->mask + 1 - (tail - head);
+    int n = (uint32_t)count < room ? count : (int)room;
+    for (int i = 0; i < n; i++) box->items[(tail + i) & box->mask] = items[i];
+    __atomic_store_n(&box->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+// 최대 max 개를 out 으로 꺼내고 꺼낸 개수 반환 (받는 스레드만 호출)
+static inline int mailbox_pop(Mailbox *box, uint64_t *out, int max)
+{
+    uint32_t head = box->head;
+    uint32_t tail = __atomic_load_n(&box->tail, __ATOMIC_ACQUIRE);
+    uint32_t ready = tail - head;
+    int n = ready < (uint32_t)max ? (int)ready : max;
+    for (int i = 0; i < n; i++) out[i] = box->items[(head + i) & box->mask];
+    __atomic_store_n(&box->head, head + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+#endif
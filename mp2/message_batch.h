@@ -0,0 +1,307 @@
+#ifndef MESSAGE_BATCH_H
+#define MESSAGE_BATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "routing_store.h"
+#include "buffered_writer.h"
+
+// 메시지 파일 일괄 처리 (linkstate / distvec 공용)
+//
+// 메시지 파일은 처음에 한 번만 읽어 (출발지, 목적지, 본문 위치) 배열로 둔다.
+// 같은 (출발지, 목적지) 쌍은 한 번만 경로를 구하고, 쌍은 목적지별로 묶는다.
+// 목적지 j 의 경로들은 다음 홉 열 j 가 이루는 트리 (노드마다 부모가 다음 홉) 를 따라가며,
+// 경로 문자열 ("from s to j cost ... message ") 을 목적지별 버퍼에 만들어 둔다.
+// 그때 지나간 노드와 그 다음 홉, 출발지의 비용을 기억해 두고, 라우팅 테이블이 바뀐 뒤에는
+// 그 값이 하나라도 달라진 목적지의 문자열만 다시 만든다.
+// 다음 홉을 따라가다 노드 수만큼 가도 목적지에 닿지 않으면 (다음 홉이 고리를 이룸) 경로 뒤에 unreachable 을 붙인다.
+// 범위 밖 노드로의 메시지는 도달할 수 없는 것으로 출력한다.
+
+typedef struct {
+    int source;
+    int destination;
+    int slot;      // 목적지 묶음 번호
+    int cost;      // 경로 문자열을 만들 때 출발지의 비용
+    size_t offset; // 목적지 묶음 버퍼 안의 경로 문자열 위치
+    size_t length;
+} MessagePair;
+
+typedef struct {
+    int node;
+    int hop;
+} TreeEdge;
+
+typedef struct {
+    int node;
+    int valid;                 // 경로 문자열이 만들어져 있는지
+    int pair_begin, pair_end;  // destination_pairs 안의 이 목적지 쌍 구간
+    TreeEdge *tree;            // 경로들이 지나간 노드와 그때의 다음 홉 (노드마다 한 번)
+    int tree_count, tree_capacity;
+    ByteBuffer text;           // 쌍들의 경로 문자열
+} MessageDestination;
+
+typedef struct {
+    ByteBuffer file;           // 메시지 파일 전체 (본문은 여기를 가리킴)
+    int count;                 // 메시지 수
+    int *pair;                 // 메시지별 쌍 번호
+    size_t *text_offset;       // 메시지별 본문 위치와 길이
+    size_t *text_length;
+    MessagePair *pairs;
+    int pair_count;
+    int *destination_pairs;    // 목적지 묶음 순서로 정렬한 쌍 번호
+    MessageDestination *destinations;
+    int destination_count;
+    int node_count;
+    int *stamp;                // 노드별: 마지막으로 트리에 넣은 다시 만들기 번호
+    int stamp_value;
+} MessageBatch;
+
+static inline void *message_batch_allocate(size_t size)
+{
+    void *p = calloc(size ? size : 1, 1);
+    if (p == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    return p;
+}
+
+// 열린 주소 해시에서 key 의 번호를 찾고, 없으면 next 를 넣고 반환
+static inline int message_batch_intern(uint64_t *keys, int *values, size_t mask, uint64_t key, int next)
+{
+    size_t h = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 17) & mask;
+    while (values[h] >= 0) {
+        if (keys[h] == key) return values[h];
+        h = (h + 1) & mask;
+    }
+    keys[h] = key;
+    values[h] = next;
+    return next;
+}
+
+// 메시지 파일을 읽어 묶음을 만듦
+// 줄마다 fscanf("%d %d %[^\n]") 와 같이 읽고, 형식이 맞지 않는 줄에서 멈춘다 (본문 길이 제한 없음).
+static inline void message_batch_load(MessageBatch *batch, FILE *file, int node_count)
+{
+    memset(batch, 0, sizeof(*batch));
+    batch->node_count = node_count;
+    while (1) { // 파일 전체를 읽음 (끝에 '\0' 을 붙여 strtol 이 멈추게 함)
+        byte_buffer_reserve(&batch->file, 1 << 16);
+        size_t got = fread(batch->file.data + batch->file.length, 1, batch->file.capacity - batch->file.length - 1, file);
+        batch->file.length += got;
+        if (got == 0) break;
+    }
+    byte_buffer_reserve(&batch->file, 1);
+    batch->file.data[batch->file.length] = '\0';
+
+    int capacity = 0;
+    const char *text = batch->file.data;
+    const char *end = text + batch->file.length;
+    const char *p = text;
+    while (1) {
+        char *after;
+        long source = strtol(p, &after, 10);
+        if (after == p) break;
+        p = after;
+        long destination = strtol(p, &after, 10);
+        if (after == p) break;
+        p = after;
+        while (p < end && isspace((unsigned char)*p)) p++;
+        const char *line = p;
+        while (p < end && *p != '\n') p++;
+        if (p == line) break;
+
+        if (batch->count == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            batch->pair = (int *)realloc(batch->pair, sizeof(int) * capacity);
+            batch->text_offset = (size_t *)realloc(batch->text_offset, sizeof(size_t) * capacity);
+            batch->text_length = (size_t *)realloc(batch->text_length, sizeof(size_t) * capacity);
+            batch->pairs = (MessagePair *)realloc(batch->pairs, sizeof(MessagePair) * capacity);
+            if (batch->pair == NULL || batch->text_offset == NULL || batch->text_length == NULL || batch->pairs == NULL) {
+                printf("Error: out of memory.\n");
+                exit(1);
+            }
+        }
+        batch->pairs[batch->count].source = (int)source; // 쌍을 합치기 전까지 메시지별로 둠
+        batch->pairs[batch->count].destination = (int)destination;
+        batch->text_offset[batch->count] = (size_t)(line - text);
+        batch->text_length[batch->count] = (size_t)(p - line);
+        batch->count++;
+    }
+
+    // 같은 쌍과 같은 목적지에 번호를 붙임
+    size_t size = 2;
+    while (size < (size_t)batch->count * 2) size <<= 1;
+    uint64_t *keys = (uint64_t *)message_batch_allocate(sizeof(uint64_t) * size);
+    int *values = (int *)message_batch_allocate(sizeof(int) * size);
+    memset(values, -1, sizeof(int) * size);
+    for (int m = 0; m < batch->count; m++) {
+        MessagePair message = batch->pairs[m];
+        uint64_t key = (uint64_t)(uint32_t)message.source << 32 | (uint32_t)message.destination;
+        int pair = message_batch_intern(keys, values, size - 1, key, batch->pair_count);
+        if (pair == batch->pair_count) batch->pairs[batch->pair_count++] = message; // 앞으로만 덮어씀 (pair <= m)
+        batch->pair[m] = pair;
+    }
+    memset(values, -1, sizeof(int) * size);
+    int *slot_size = (int *)message_batch_allocate(sizeof(int) * (batch->pair_count + 1));
+    batch->destinations = (MessageDestination *)message_batch_allocate(sizeof(MessageDestination) * (batch->pair_count + 1));
+    for (int q = 0; q < batch->pair_count; q++) {
+        MessagePair *pair = &batch->pairs[q];
+        pair->slot = message_batch_intern(keys, values, size - 1, (uint32_t)pair->destination, batch->destination_count);
+        if (pair->slot == batch->destination_count) batch->destinations[batch->destination_count++].node = pair->destination;
+        slot_size[pair->slot]++;
+    }
+    free(keys);
+    free(values);
+
+    // 쌍을 목적지 묶음 순서로 정렬 (계수 정렬)
+    batch->destination_pairs = (int *)message_batch_allocate(sizeof(int) * (batch->pair_count + 1));
+    int start = 0;
+    for (int d = 0; d < batch->destination_count; d++) {
+        batch->destinations[d].pair_begin = batch->destinations[d].pair_end = start;
+        start += slot_size[d];
+    }
+    for (int q = 0; q < batch->pair_count; q++) {
+        batch->destination_pairs[batch->destinations[batch->pairs[q].slot].pair_end++] = q;
+    }
+    free(slot_size);
+    batch->stamp = (int *)message_batch_allocate(sizeof(int) * (node_count + 1));
+}
+
+static inline int message_batch_in_range(const MessageBatch *batch, int node)
+{
+    return node >= 0 && node < batch->node_count;
+}
+
+// 목적지의 경로 문자열을 만든 뒤 라우팅 테이블의 해당 값이 바뀌었는지
+static inline int message_batch_stale(const MessageBatch *batch, const MessageDestination *dest, const RoutingStore *store)
+{
+    if (!dest->valid) return 1;
+    for (int k = dest->pair_begin; k < dest->pair_end; k++) {
+        const MessagePair *pair = &batch->pairs[batch->destination_pairs[k]];
+        if (message_batch_in_range(batch, pair->source) && message_batch_in_range(batch, dest->node) &&
+            store_cost(store, pair->source, dest->node) != pair->cost)
+            return 1;
+    }
+    for (int e = 0; e < dest->tree_count; e++) {
+        if (store_next_hop(store, dest->tree[e].node, dest->node) != dest->tree[e].hop) return 1;
+    }
+    return 0;
+}
+
+// 지나간 노드와 다음 홉을 기억 (다시 만들기마다 노드당 한 번)
+static inline void message_batch_record(MessageBatch *batch, MessageDestination *dest, int node, int hop)
+{
+    if (batch->stamp[node] == batch->stamp_value) return;
+    batch->stamp[node] = batch->stamp_value;
+    if (dest->tree_count == dest->tree_capacity) {
+        dest->tree_capacity = dest->tree_capacity ? dest->tree_capacity * 2 : 16;
+        dest->tree = (TreeEdge *)realloc(dest->tree, sizeof(TreeEdge) * dest->tree_capacity);
+        if (dest->tree == NULL) {
+            printf("Error: out of memory.\n");
+            exit(1);
+        }
+    }
+    dest->tree[dest->tree_count].node = node;
+    dest->tree[dest->tree_count].hop = hop;
+    dest->tree_count++;
+}
+
+// 목적지 하나의 경로 문자열을 모두 다시 만듦
+static inline void message_batch_rebuild(MessageBatch *batch, MessageDestination *dest, const RoutingStore *store)
+{
+    int j = dest->node;
+    dest->text.length = 0;
+    dest->tree_count = 0;
+    batch->stamp_value++;
+    for (int k = dest->pair_begin; k < dest->pair_end; k++) {
+        MessagePair *pair = &batch->pairs[batch->destination_pairs[k]];
+        ByteBuffer *out = &dest->text;
+        int s = pair->source;
+        pair->offset = out->length;
+        byte_buffer_put(out, "from ", 5);
+        byte_buffer_put_int(out, s);
+        byte_buffer_put(out, " to ", 4);
+        byte_buffer_put_int(out, j);
+        byte_buffer_put(out, " cost ", 6);
+        int next = -1; // 다음 홉 없음 (NOT_EXIST)
+        if (message_batch_in_range(batch, s) && message_batch_in_range(batch, j)) {
+            pair->cost = store_cost(store, s, j);
+            next = store_next_hop(store, s, j);
+            message_batch_record(batch, dest, s, next);
+        }
+        if (next == -1) {
+            byte_buffer_put(out, "infinite hops unreachable ", 26);
+        } else {
+            byte_buffer_put_int(out, pair->cost);
+            byte_buffer_put(out, " hops ", 6);
+            byte_buffer_put_int(out, s);
+            byte_buffer_put_char(out, ' ');
+            int steps = 0;
+            while (next != j) {
+                if (!message_batch_in_range(batch, next) || steps++ >= batch->node_count) { // 고리이거나 끊긴 경로
+                    byte_buffer_put(out, "unreachable ", 12);
+                    break;
+                }
+                byte_buffer_put_int(out, next);
+                byte_buffer_put_char(out, ' ');
+                int hop = store_next_hop(store, next, j);
+                message_batch_record(batch, dest, next, hop);
+                next = hop;
+            }
+        }
+        byte_buffer_put(out, "message ", 8);
+        pair->length = out->length - pair->offset;
+    }
+    dest->valid = 1;
+}
+
+// 라우팅 테이블이 바뀐 뒤 영향을 받은 목적지의 경로 문자열만 다시 만들고, 다시 만든 목적지 수 반환
+static inline int message_batch_refresh(MessageBatch *batch, const RoutingStore *store)
+{
+    int rebuilt = 0;
+    for (int d = 0; d < batch->destination_count; d++) {
+        MessageDestination *dest = &batch->destinations[d];
+        if (message_batch_stale(batch, dest, store)) {
+            message_batch_rebuild(batch, dest, store);
+            rebuilt++;
+        }
+    }
+    return rebuilt;
+}
+
+// 모든 메시지를 파일 순서대로 출력하고 빈 줄을 붙임
+static inline void message_batch_write(const MessageBatch *batch, BufferedWriter *writer)
+{
+    for (int m = 0; m < batch->count; m++) {
+        const MessagePair *pair = &batch->pairs[batch->pair[m]];
+        const MessageDestination *dest = &batch->destinations[pair->slot];
+        byte_buffer_put(&writer->buffer, dest->text.data + pair->offset, pair->length);
+        byte_buffer_put(&writer->buffer, batch->file.data + batch->text_offset[m], batch->text_length[m]);
+        byte_buffer_put_char(&writer->buffer, '\n');
+        writer_maybe_flush(writer);
+    }
+    byte_buffer_put_char(&writer->buffer, '\n');
+}
+
+static inline void message_batch_free(MessageBatch *batch)
+{
+    for (int d = 0; d < batch->destination_count; d++) {
+        free(batch->destinations[d].tree);
+        byte_buffer_free(&batch->destinations[d].text);
+    }
+    byte_buffer_free(&batch->file);
+    free(batch->pair);
+    free(batch->text_offset);
+    free(batch->text_length);
+    free(batch->pairs);
+    free(batch->destination_pairs);
+    free(batch->destinations);
+    free(batch->stamp);
+}
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef MINPLUS_H
+#define MINPLUS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <immintrin.h>
+
+// distvec 모든 칸 라운드용 min-plus 커널
+//
+// 출발지 행 a 와 목적지 열 b (전치해 둔 비용 배열의 한 행) 로 min_k (a[k] + b[k]) 를 구하고,
+// 그 값을 내는 k 를 앞에서부터 찾는다. 두 벡터가 모두 연속이라 SIMD 로 한 번에 여러 k 를 본다.
+// AVX-512 / AVX2 가 있으면 그 명령을, 없으면 스칼라 루프를 쓰며 결과는 같다.
+// 16 비트 비용은 포화 덧셈을 쓴다. 합이 INT16_MAX 를 넘는 후보는 지금 비용(INT16_MAX 이하)보다
+// 작을 수 없으므로 비교 결과가 달라지지 않는다.
+// MINPLUS_ISA=scalar|avx2|avx512 로 쓸 명령을 정할 수 있다 (결과 비교용).
+
+typedef int (*minplus16_fn)(const int16_t *a, const int16_t *b, int n);
+typedef int (*find16_fn)(const int16_t *a, const int16_t *b, int n, int start, int value);
+typedef int (*minplus32_fn)(const int32_t *a, const int32_t *b, int n);
+typedef int (*find32_fn)(const int32_t *a, const int32_t *b, int n, int start, int value);
+
+typedef struct {
+    const char *name;
+    minplus16_fn min16;
+    find16_fn find16;
+    minplus32_fn min32;
+    find32_fn find32;
+} MinPlusKernel;
+
+// 스칼라
+
+static int minplus16_scalar(const int16_t *a, const int16_t *b, int n)
+{
+    int best = INT_MAX;
+    for (int k = 0; k < n; k++) {
+        int v = a[k] + b[k];
+        if (v < best) best = v;
+    }
+    return best > INT16_MAX ? INT16_MAX : best;
+}
+
+static int find16_scalar(const int16_t *a, const int16_t *b, int n, int start, int value)
+{
+    for (int k = start; k < n; k++) {
+        if (a[k] + b[k] == value) return k;
+    }
+    return n;
+}
+
+static int minplus32_scalar(const int32_t *a, const int32_t *b, int n)
+{
+    int best = INT_MAX;
+    for (int k = 0; k < n; k++) {
+        int v = a[k] + b[k];
+        if (v < best) best = v;
+    }
+    return best;
+}
+
+static int find32_scalar(const int32_t *a, const int32_t *b, int n, int start, int value)
+{
+    for (int k = start; k < n; k++) {
+        if (a[k] + b[k] == value) return k;
+    }
+    return n;
+}
+
+// AVX2
+
+__attribute__((target("avx2"))) static int minplus16_avx2(const int16_t *a, const int16_t *b, int n)
+{
+    __m256i best = _mm256_set1_epi16(INT16_MAX);
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m256i sum = _mm256_adds_epi16(_mm256_loadu_si256((const __m256i *)(a + k)),
+                                        _mm256_loadu_si256((const __m256i *)(b + k)));
+        best = _mm256_min_epi16(best, sum);
+    }
+    __m128i half = _mm_min_epi16(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    // 값이 모두 0 이상이라 부호 없는 최솟값 명령을 쓸 수 있다
+    int result = _mm_extract_epi16(_mm_minpos_epu16(half), 0);
+    for (; k < n; k++) {
+        int v = a[k] + b[k];
+        if (v < result) result = v;
+    }
+    return result;
+}
+
+__attribute__((target("avx2"))) static int find16_avx2(const int16_t *a, const int16_t *b, int n, int start, int value)
+{
+    __m256i target = _mm256_set1_epi16((int16_t)value);
+    int k = start;
+    for (; k + 16 <= n; k += 16) {
+        __m256i sum = _mm256_adds_epi16(_mm256_loadu_si256((const __m256i *)(a + k)),
+                                        _mm256_loadu_si256((const __m256i *)(b + k)));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi16(sum, target));
+        if (mask) return k + __builtin_ctz(mask) / 2; // 한 칸에 2 비트
+    }
+    return find16_scalar(a, b, n, k, value);
+}
+
+__attribute__((target("avx2"))) static int minplus32_avx2(const int32_t *a, const int32_t *b, int n)
+{
+    __m256i best = _mm256_set1_epi32(INT_MAX);
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i sum = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(a + k)),
+                                       _mm256_loadu_si256((const __m256i *)(b + k)));
+        best = _mm256_min_epi32(best, sum);
+    }
+    __m128i half = _mm_min_epi32(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    int result = _mm_cvtsi128_si32(half);
+    for (; k < n; k++) {
+        int v = a[k] + b[k];
+        if (v < result) result = v;
+    }
+    return result;
+}
+
+__attribute__((target("avx2"))) static int find32_avx2(const int32_t *a, const int32_t *b, int n, int start, int value)
+{
+    __m256i target = _mm256_set1_epi32(value);
+    int k = start;
+    for (; k + 8 <= n; k += 8) {
+        __m256i sum = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(a + k)),
+                                       _mm256_loadu_si256((const __m256i *)(b + k)));
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(sum, target)));
+        if (mask) return k + __builtin_ctz(mask);
+    }
+    return find32_scalar(a, b, n, k, value);
+}
+
+// AVX-512
+
+__attribute__((target("avx512f,avx512bw"))) static int minplus16_avx512(const int16_t *a, const int16_t *b, int n)
+{
+    __m512i best = _mm512_set1_epi16(INT16_MAX);
+    int k = 0;
+    for (; k + 32 <= n; k += 32) {
+        __m512i sum = _mm512_adds_epi16(_mm512_loadu_si512(a + k), _mm512_loadu_si512(b + k));
+        best = _mm512_min_epi16(best, sum);
+    }
+    if (k < n) { // 남은 칸은 마스크로 읽음
+        __mmask32 tail = (__mmask32)((1ULL << (n - k)) - 1);
+        __m512i sum = _mm512_adds_epi16(_mm512_maskz_loadu_epi16(tail, a + k), _mm512_maskz_loadu_epi16(tail, b + k));
+        best = _mm512_mask_min_epi16(best, tail, best, sum);
+    }
+    int16_t lanes[32]; // 가로 최솟값은 한 번만 구하므로 저장 후 스칼라로
+    _mm512_storeu_si512(lanes, best);
+    int result = INT16_MAX;
+    for (int l = 0; l < 32; l++) {
+        if (lanes[l] < result) result = lanes[l];
+    }
+    return result;
+}
+
+__attribute__((target("avx512f,avx512bw"))) static int find16_avx512(const int16_t *a, const int16_t *b, int n, int start,
+                                                                    int value)
+{
+    __m512i target = _mm512_set1_epi16((int16_t)value);
+    int k = start;
+    for (; k + 32 <= n; k += 32) {
+        __m512i sum = _mm512_adds_epi16(_mm512_loadu_si512(a + k), _mm512_loadu_si512(b + k));
+        __mmask32 mask = _mm512_cmpeq_epi16_mask(sum, target);
+        if (mask) return k + __builtin_ctz(mask);
+    }
+    return find16_scalar(a, b, n, k, value);
+}
+
+__attribute__((target("avx512f"))) static int minplus32_avx512(const int32_t *a, const int32_t *b, int n)
+{
+    __m512i best = _mm512_set1_epi32(INT_MAX);
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m512i sum = _mm512_add_epi32(_mm512_loadu_si512(a + k), _mm512_loadu_si512(b + k));
+        best = _mm512_maskz_min_epi32((__mmask16)-1, best, sum); // GCC 12 의 _mm512_min_epi32 는 잘못된 초기화 경고를 냄
+    }
+    if (k < n) {
+        __mmask16 tail = (__mmask16)((1U << (n - k)) - 1);
+        __m512i sum = _mm512_add_epi32(_mm512_maskz_loadu_epi32(tail, a + k), _mm512_maskz_loadu_epi32(tail, b + k));
+        best = _mm512_mask_min_epi32(best, tail, best, sum);
+    }
+    int32_t lanes[16];
+    _mm512_storeu_si512(lanes, best);
+    int result = INT_MAX;
+    for (int l = 0; l < 16; l++) {
+        if (lanes[l] < result) result = lanes[l];
+    }
+    return result;
+}
+
+__attribute__((target("avx512f"))) static int find32_avx512(const int32_t *a, const int32_t *b, int n, int start, int value)
+{
+    __m512i target = _mm512_set1_epi32(value);
+    int k = start;
+    for (; k + 16 <= n; k += 16) {
+        __m512i sum = _mm512_add_epi32(_mm512_loadu_si512(a + k), _mm512_loadu_si512(b + k));
+        __mmask16 mask = _mm512_cmpeq_epi32_mask(sum, target);
+        if (mask) return k + __builtin_ctz(mask);
+    }
+    return find32_scalar(a, b, n, k, value);
+}
+
+// CPU 와 MINPLUS_ISA 로 커널 선택
+static inline MinPlusKernel minplus_select(void)
+{
+    static const MinPlusKernel scalar = {"scalar", minplus16_scalar, find16_scalar, minplus32_scalar, find32_scalar};
+    static const MinPlusKernel avx2 = {"avx2", minplus16_avx2, find16_avx2, minplus32_avx2, find32_avx2};
+    static const MinPlusKernel avx512 = {"avx512", minplus16_avx512, find16_avx512, minplus32_avx512, find32_avx512};
+    __builtin_cpu_init();
+    int has_avx2 = __builtin_cpu_supports("avx2");
+    int has_avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    const char *env = getenv("MINPLUS_ISA");
+    if (env && strcmp(env, "scalar") == 0) return scalar;
+    if (env && strcmp(env, "avx2") == 0) return has_avx2 ? avx2 : scalar;
+    if (has_avx512) return avx512;
+    return has_avx2 ? avx2 : scalar;
+}
+
+static MinPlusKernel minplus_kernel; // minplus_init 으로 채움
+
+static inline void minplus_init(void)
+{
+    minplus_kernel = minplus_select();
+}
+
+// 비용 타입별 호출
+static inline int minplus_min(const int16_t *a, const int16_t *b, int n) { return minplus_kernel.min16(a, b, n); }
+static inline int minplus_min(const int32_t *a, const int32_t *b, int n) { return minplus_kernel.min32(a, b, n); }
+static inline int minplus_find(const int16_t *a, const int16_t *b, int n, int start, int value)
+{
+    return minplus_kernel.find16(a, b, n, start, value);
+}
+static inline int minplus_find(const int32_t *a, const int32_t *b, int n, int start, int value)
+{
+    return minplus_kernel.find32(a, b, n, start, value);
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef ROUTING_STORE_H
+#define ROUTING_STORE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// 라우팅 테이블 저장소 (linkstate / distvec 공용)
+//
+// 비용과 다음 홉을 따로 node_count x node_count 행 우선 배열로 저장한다.
+// 한 출발지의 행이 연속이라 행을 훑는 계산과 출력이 캐시를 순서대로 쓴다.
+// 다음 홉은 노드 수에 따라 1, 2, 4 바이트, 비용은 링크 비용 범위에 따라 2, 4 바이트로 저장한다.
+// 링크 비용이 바뀌어 범위를 넘으면 routing_store_prepare 가 더 넓게 다시 할당한다.
+// 한 칸씩 읽고 쓸 때는 store_cost / store_set 을, 행 전체를 도는 계산 루프는
+// ROUTING_STORE_DISPATCH 로 폭별로 특수화한 함수를 쓴다.
+
+typedef struct {
+    int node_count;
+    int cost_width; // 비용 한 칸의 바이트 수
+    int hop_width;  // 다음 홉 한 칸의 바이트 수
+    void *cost;
+    void *next_hop;
+} RoutingStore;
+
+static inline int packed_get(const void *base, int width, size_t i)
+{
+    switch (width) {
+    case 1: return ((const int8_t *)base)[i];
+    case 2: return ((const int16_t *)base)[i];
+    default: return ((const int32_t *)base)[i];
+    }
+}
+
+static inline void packed_set(void *base, int width, size_t i, int value)
+{
+    switch (width) {
+    case 1: ((int8_t *)base)[i] = (int8_t)value; break;
+    case 2: ((int16_t *)base)[i] = (int16_t)value; break;
+    default: ((int32_t *)base)[i] = value; break;
+    }
+}
+
+static inline size_t store_index(const RoutingStore *store, int source, int destination)
+{
+    return (size_t)source * store->node_count + destination;
+}
+
+static inline int store_cost(const RoutingStore *store, int source, int destination)
+{
+    return packed_get(store->cost, store->cost_width, store_index(store, source, destination));
+}
+
+static inline int store_next_hop(const RoutingStore *store, int source, int destination)
+{
+    return packed_get(store->next_hop, store->hop_width, store_index(store, source, destination));
+}
+
+static inline void store_set(RoutingStore *store, int source, int destination, int cost, int next_hop)
+{
+    size_t i = store_index(store, source, destination);
+    packed_set(store->cost, store->cost_width, i, cost);
+    packed_set(store->next_hop, store->hop_width, i, next_hop);
+}
+
+// 계산 루프용: 저장 폭에 맞는 타입으로 특수화한 FN<비용 타입, 다음 홉 타입>(...) 호출
+#define ROUTING_STORE_DISPATCH(store, FN, ...)                                                  \
+    ((store)->cost_width == 2 ? ROUTING_STORE_DISPATCH_HOP(store, int16_t, FN, __VA_ARGS__)     \
+                              : ROUTING_STORE_DISPATCH_HOP(store, int32_t, FN, __VA_ARGS__))
+#define ROUTING_STORE_DISPATCH_HOP(store, C, FN, ...)                                           \
+    ((store)->hop_width == 1   ? FN<C, int8_t>(__VA_ARGS__)                                     \
+     : (store)->hop_width == 2 ? FN<C, int16_t>(__VA_ARGS__)                                    \
+                               : FN<C, int32_t>(__VA_ARGS__))
+
+// 링크 비용이 [min_cost, max_cost] 일 때 쓸 수 있도록 저장소를 준비 (내용은 초기화하지 않음)
+// 음수 비용은 경로 비용이 계속 작아질 수 있으므로 4 바이트를 쓴다
+static inline void routing_store_prepare(RoutingStore *store, int node_count, int min_cost, int max_cost)
+{
+    int cost_width = min_cost >= 0 && max_cost <= INT16_MAX ? 2 : 4;
+    int hop_width = node_count <= INT8_MAX ? 1 : node_count <= INT16_MAX ? 2 : 4;
+    if (store->cost && store->node_count == node_count && store->cost_width >= cost_width &&
+        store->hop_width == hop_width)
+        return;
+
+    size_t cells = (size_t)node_count * node_count;
+    free(store->cost);
+    free(store->next_hop);
+    store->node_count = node_count;
+    store->cost_width = cost_width;
+    store->hop_width = hop_width;
+    store->cost = malloc(cells * cost_width + 1);
+    store->next_hop = malloc(cells * hop_width + 1);
+    if (store->cost == NULL || store->next_hop == NULL) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+}
+
+static inline void routing_store_free(RoutingStore *store)
+{
+    free(store->cost);
+    free(store->next_hop);
+    store->cost = NULL;
+    store->next_hop = NULL;
+}
+
+#endif
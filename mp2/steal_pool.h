@@ -0,0 +1,141 @@
+#ifndef STEAL_POOL_H
+#define STEAL_POOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// 작업 훔치기 병렬 처리 (서로 독립인 작업 0 .. count - 1)
+//
+// 작업 번호를 스레드 수만큼 연속 구간으로 나눠 주고, 각 스레드는 자기 구간 앞에서부터 하나씩 처리한다.
+// 자기 구간이 비면 다른 스레드 구간의 뒤쪽 절반을 가져온다. 작업마다 걸리는 시간이 달라도
+// (출발지마다 최단 경로 트리 크기가 다름) 모든 스레드가 끝까지 바쁘게 돈다.
+// 작업은 스레드 번호(worker)와 함께 호출되므로 스레드별 작업 공간을 worker 로 고르면 된다.
+// 어느 스레드가 어떤 작업을 맡는지는 실행마다 다르므로 작업끼리 결과를 공유하면 안 된다.
+
+typedef void (*steal_fn)(void *ctx, int worker, int index);
+
+typedef struct {
+    pthread_mutex_t lock;
+    int next; // 다음에 처리할 작업 번호
+    int end;  // 구간 끝 (포함하지 않음)
+    char pad[64]; // 스레드별 구간을 다른 캐시 라인에 둠
+} StealRange;
+
+typedef struct {
+    StealRange *ranges;
+    int threads;
+    steal_fn work;
+    void *ctx;
+} StealPool;
+
+typedef struct {
+    StealPool *pool;
+    int worker;
+} StealWorker;
+
+// 사용할 수 있는 CPU 수
+static inline int steal_pool_cpus(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+// 자기 구간에서 작업 하나를 꺼냄, 비었으면 0
+static inline int steal_take(StealRange *range, int *index)
+{
+    int ok = 0;
+    pthread_mutex_lock(&range->lock);
+    if (range->next < range->end) {
+        *index = range->next++;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&range->lock);
+    return ok;
+}
+
+// 다른 스레드 구간의 뒤쪽 절반을 자기 구간으로 가져옴, 남은 작업이 없으면 0
+static inline int steal_from_others(StealPool *pool, int self)
+{
+    for (int i = 1; i < pool->threads; i++) {
+        StealRange *victim = &pool->ranges[(self + i) % pool->threads];
+        pthread_mutex_lock(&victim->lock);
+        int left = victim->end - victim->next;
+        if (left <= 0) {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+        int end = victim->end;
+        int begin = end - (left + 1) / 2; // 하나 남았으면 그 하나
+        victim->end = begin;
+        pthread_mutex_unlock(&victim->lock);
+
+        StealRange *own = &pool->ranges[self];
+        pthread_mutex_lock(&own->lock);
+        own->next = begin;
+        own->end = end;
+        pthread_mutex_unlock(&own->lock);
+        return 1;
+    }
+    return 0;
+}
+
+static void *steal_worker(void *arg)
+{
+    StealWorker *w = (StealWorker *)arg;
+    StealPool *pool = w->pool;
+    int index;
+    while (1) {
+        while (steal_take(&pool->ranges[w->worker], &index)) {
+            pool->work(pool->ctx, w->worker, index);
+        }
+        if (!steal_from_others(pool, w->worker)) break;
+    }
+    return NULL;
+}
+
+// 작업 count 개를 최대 threads 개의 스레드로 처리 (worker 는 0 .. threads - 1)
+static void steal_pool_run(int threads, int count, steal_fn work, void *ctx)
+{
+    if (threads > count) threads = count;
+    if (threads <= 1) { // 단일 스레드: 차례대로 처리
+        for (int i = 0; i < count; i++) work(ctx, 0, i);
+        return;
+    }
+
+    StealPool pool;
+    pool.threads = threads;
+    pool.work = work;
+    pool.ctx = ctx;
+    pool.ranges = (StealRange *)calloc(threads, sizeof(StealRange));
+    StealWorker *workers = (StealWorker *)calloc(threads, sizeof(StealWorker));
+    pthread_t *tids = (pthread_t *)calloc(threads, sizeof(pthread_t));
+    if (!pool.ranges || !workers || !tids) {
+        printf("Error: out of memory.\n");
+        exit(1);
+    }
+    for (int t = 0; t < threads; t++) { // 작업을 고르게 나눠 줌
+        pthread_mutex_init(&pool.ranges[t].lock, NULL);
+        pool.ranges[t].next = (int)((long long)count * t / threads);
+        pool.ranges[t].end = (int)((long long)count * (t + 1) / threads);
+        workers[t].pool = &pool;
+        workers[t].worker = t;
+    }
+
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&tids[t], NULL, steal_worker, &workers[t]) != 0) {
+            printf("Error: create thread.\n");
+            exit(1);
+        }
+    }
+    steal_worker(&workers[0]); // 0 번은 호출한 스레드가 맡음
+    for (int t = 1; t < threads; t++) pthread_join(tids[t], NULL);
+
+    for (int t = 0; t < threads; t++) pthread_mutex_destroy(&pool.ranges[t].lock);
+    free(pool.ranges);
+    free(workers);
+    free(tids);
+}
+
+#endif
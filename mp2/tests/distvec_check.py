@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+# distvec 무작위 검사
+#
+# 무작위 토폴로지 / 변경 / 메시지 파일을 만들어 distvec 를 기본 방식과 다른 방식으로 실행하고 출력을 비교한다.
+#   -w, -w -s, -w -p : 모든 테이블과 메시지의 비용이 기본 방식과 같고, 테이블의 다음 홉이 실제 링크를 따라
+#                      그 비용을 내는지 확인 (비용이 같은 경로가 여럿이면 다음 홉은 기본 방식과 다를 수 있음)
+#   -j 2, -j 3, -j 8 : 기본 방식과 -w 방식마다 -j 없이 실행한 출력과 바이트 단위로 같은지 확인
+# 시드 10 개 중 하나는 -j 가 라운드를 타일로 나누도록 노드 수를 DV_TILE (64) 보다 크게 만든다.
+# 자기 자신으로의 링크, 끊긴 링크 (-999), 비용 999 링크, 같은 노드 쌍의 여러 링크를 섞어 만든다.
+#
+# 사용법: g++ -O2 -o distvec distvec_20200152.cc -lpthread
+#         python3 tests/distvec_check.py ./distvec [시드 수]
+
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+INFINITY_COST = 999
+
+
+def generate(seed):
+    r = random.Random(seed)
+    n = r.randint(2, 40) if seed % 10 else r.randint(65, 200)
+
+    def cost():
+        x = r.random()
+        if x < 0.6:
+            return r.randint(1, 4)
+        if x < 0.9:
+            return r.randint(1, 300)
+        return INFINITY_COST
+
+    links = []
+    for _ in range(r.randint(1, n * 3)):
+        a, b = r.randrange(n), r.randrange(n)
+        if a == b and r.random() < 0.9:
+            b = (a + 1) % n
+        links.append((a, b, cost()))
+    changes = []
+    for _ in range(r.randint(0, 8)):
+        if links and r.random() < 0.6:
+            a, b, _ = r.choice(links)
+        else:
+            a, b = r.randrange(n), r.randrange(n)
+            if r.random() < 0.1:
+                b = a  # 자기 자신으로의 링크
+        changes.append((a, b, -999 if r.random() < 0.4 else cost()))
+    messages = [(r.randrange(n), r.randrange(n), "m%d" % i) for i in range(4)]
+    return n, links, changes, messages
+
+
+def write_files(directory, n, links, changes, messages):
+    with open(os.path.join(directory, "topology.txt"), "w") as f:
+        f.write("%d\n" % n + "".join("%d %d %d\n" % l for l in links))
+    with open(os.path.join(directory, "changes.txt"), "w") as f:
+        f.write("".join("%d %d %d\n" % c for c in changes))
+    with open(os.path.join(directory, "messages.txt"), "w") as f:
+        f.write("".join("%d %d %s\n" % m for m in messages))
+
+
+def run(binary, options, directory):
+    p = subprocess.run([binary] + options + ["topology.txt", "messages.txt", "changes.txt"], cwd=directory,
+                       capture_output=True, text=True)
+    if p.returncode != 0:
+        return None
+    with open(os.path.join(directory, "output_dv.txt")) as f:
+        return f.read()
+
+
+def link_states(links, changes):
+    # 변경마다의 노드 쌍 비용 (distvec 의 update_link_cost 와 같이 첫 링크를 바꾸고, 같은 쌍은 마지막 링크가 유효)
+    table = [list(l) for l in links]
+
+    def pair_costs():
+        costs = {}
+        for a, b, c in table:
+            costs[(a, b)] = costs[(b, a)] = c
+        return costs
+
+    states = [pair_costs()]
+    for a, b, c in changes:
+        if c == -999:
+            c = INFINITY_COST
+        for link in table:
+            if (link[0], link[1]) in ((a, b), (b, a)):
+                link[2] = c
+                break
+        else:
+            if c != INFINITY_COST:
+                table.append([a, b, c])
+        states.append(pair_costs())
+    return states
+
+
+def parse(output, n):
+    # 출력을 단계 (테이블 + 메시지) 로 나눔: 테이블은 {(i, j): (다음 홉, 비용)}, 메시지는 "from .. cost X" 목록
+    lines = output.split("\n")
+    phases, pos = [], 0
+    while pos < len(lines) and lines[pos:] != [""]:
+        table = {}
+        for i in range(n):
+            while lines[pos] != "":
+                j, hop, c = map(int, lines[pos].split())
+                table[(i, j)] = (hop, c)
+                pos += 1
+            pos += 1
+        messages = []
+        while lines[pos] != "":
+            messages.append(" ".join(lines[pos].split()[:6]))
+            pos += 1
+        pos += 1
+        phases.append((table, messages))
+    return phases
+
+
+def check_costs(reference, output, n, states):
+    want, got = parse(reference, n), parse(output, n)
+    if len(want) != len(got):
+        return "phase count"
+    for phase, ((want_table, want_messages), (table, messages)) in enumerate(zip(want, got)):
+        if {k: v[1] for k, v in want_table.items()} != {k: v[1] for k, v in table.items()}:
+            return "table costs after %d changes" % phase
+        if want_messages != messages:
+            return "message costs after %d changes" % phase
+        for (i, j), (hop, c) in table.items():
+            if i == j:
+                continue
+            rest = 0 if hop == j else table.get((hop, j), (None, INFINITY_COST))[1]
+            if states[phase].get((i, hop), INFINITY_COST) + rest != c:
+                return "next hop %d of (%d, %d) after %d changes" % (hop, i, j, phase)
+    return None
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("usage: distvec_check.py distvec [seeds]")
+        return 2
+    binary = os.path.abspath(sys.argv[1])
+    seeds = int(sys.argv[2]) if len(sys.argv) > 2 else 300
+    failures = 0
+    with tempfile.TemporaryDirectory() as directory:
+        for seed in range(seeds):
+            n, links, changes, messages = generate(seed)
+            write_files(directory, n, links, changes, messages)
+            reference = run(binary, [], directory)
+            if reference is None:
+                print("seed %d: distvec failed" % seed)
+                failures += 1
+                continue
+            states = link_states([l for l in links if l[0] < n and l[1] < n], changes)
+            for options in ([], ["-w"], ["-w", "-s"], ["-w", "-p"]):
+                output = reference if not options else run(binary, options, directory)
+                problem = "failed" if output is None else options and check_costs(reference, output, n, states)
+                if problem:
+                    print("seed %d %s: %s" % (seed, " ".join(options), problem))
+                    failures += 1
+                    continue
+                for threads in ("2", "3", "8"):
+                    parallel = run(binary, options + ["-j", threads], directory)
+                    if parallel != output:
+                        print("seed %d %s -j %s: %s" % (seed, " ".join(options), threads,
+                                                        "failed" if parallel is None else "output differs"))
+                        failures += 1
+    print("%d failures" % failures)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
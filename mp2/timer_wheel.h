@@ -0,0 +1,150 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// 계층 타이머 휠 (dvsim 의 이벤트 큐)
+//
+// 시각은 32 비트 틱. 단계마다 256 칸이고, 지금부터 256 틱 안의 이벤트는 0 단계에,
+// 2^16 틱 안은 1 단계에 ... 넣는다. 0 단계가 한 바퀴 돌 때마다 윗 단계의 다음 칸을 아래로 내린다.
+// 추가와 꺼내기가 이벤트 수와 무관하게 상수 시간이다.
+// 같은 시각의 이벤트는 넣은 순서대로 꺼낸다.
+// 휠은 이벤트 번호만 관리하고, 이벤트 내용은 호출한 쪽이 번호로 찾는 배열에 둔다.
+
+#define WHEEL_LEVELS 4
+#define WHEEL_BITS 8
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+
+typedef struct {
+    uint32_t now;                                // 지금 시각 (이보다 이른 이벤트는 없음)
+    int head[WHEEL_LEVELS][WHEEL_SLOTS];         // 칸별 이벤트 목록 (-1 이면 빈 칸)
+    int tail[WHEEL_LEVELS][WHEEL_SLOTS];
+    int level_count[WHEEL_LEVELS];               // 단계별 이벤트 수
+    int count;                                   // 전체 이벤트 수
+    uint32_t *time;                              // 이벤트별 시각
+    int *next;                                   // 이벤트별 같은 칸의 다음 이벤트, 빈 번호 목록
+    int capacity;                                // 이벤트 번호 수
+    int free_list;                               // 재사용할 번호 (-1 이면 없음)
+} TimerWheel;
+
+static inline void timer_wheel_init(TimerWheel *w)
+{
+    memset(w, 0, sizeof(*w));
+    memset(w->head, -1, sizeof(w->head));
+    memset(w->tail, -1, sizeof(w->tail));
+    w->free_list = -1;
+}
+
+static inline void timer_wheel_free(TimerWheel *w)
+{
+    free(w->time);
+    free(w->next);
+    w->time = NULL;
+    w->next = NULL;
+}
+
+// 빈 휠의 시각을 0 으로 되돌림 (이벤트 번호 저장 공간은 그대로 씀)
+static inline void timer_wheel_reset(TimerWheel *w)
+{
+    if (w->count != 0) {
+        printf("Error: reset a timer wheel with pending events.\n");
+        exit(1);
+    }
+    w->now = 0;
+}
+
+// 시각 t 의 이벤트를 알맞은 단계의 칸 끝에 붙임
+static inline void timer_wheel_place(TimerWheel *w, int event)
+{
+    uint32_t t = w->time[event];
+    uint32_t delta = t - w->now;
+    int level = 0;
+    while (level + 1 < WHEEL_LEVELS && delta >= (1u << (WHEEL_BITS * (level + 1)))) level++;
+    int slot = (int)((t >> (WHEEL_BITS * level)) & WHEEL_MASK);
+    w->next[event] = -1;
+    if (w->tail[level][slot] < 0) {
+        w->head[level][slot] = event;
+    } else {
+        w->next[w->tail[level][slot]] = event;
+    }
+    w->tail[level][slot] = event;
+    w->level_count[level]++;
+}
+
+// 시각 t (now 이상) 의 이벤트를 추가하고 번호 반환
+static inline int timer_wheel_add(TimerWheel *w, uint32_t t)
+{
+    if (w->free_list < 0) { // 번호가 모두 쓰이는 중이면 두 배로 늘림
+        int capacity = w->capacity ? w->capacity * 2 : 1024;
+        w->time = (uint32_t *)realloc(w->time, sizeof(uint32_t) * capacity);
+        w->next = (int *)realloc(w->next, sizeof(int) * capacity);
+        if (w->time == NULL || w->next == NULL) {
+            printf("Error: out of memory.\n");
+            exit(1);
+        }
+        for (int i = w->capacity; i < capacity; i++) w->next[i] = i + 1 < capacity ? i + 1 : -1;
+        w->free_list = w->capacity;
+        w->capacity = capacity;
+    }
+    int event = w->free_list;
+    w->free_list = w->next[event];
+    w->time[event] = t;
+    timer_wheel_place(w, event);
+    w->count++;
+    return event;
+}
+
+// 다 쓴 이벤트 번호 반환
+static inline void timer_wheel_release(TimerWheel *w, int event)
+{
+    w->next[event] = w->free_list;
+    w->free_list = event;
+}
+
+// level 단계의 칸을 비우고 이벤트를 다시 배치 (아래 단계로 내려감)
+static inline void timer_wheel_cascade(TimerWheel *w, int level, int slot)
+{
+    int event = w->head[level][slot];
+    w->head[level][slot] = w->tail[level][slot] = -1;
+    while (event >= 0) {
+        int next = w->next[event];
+        w->level_count[level]--;
+        timer_wheel_place(w, event);
+        event = next;
+    }
+}
+
+// 시각을 한 틱 (0 단계가 비었으면 다음 0 단계 바퀴까지) 진행
+static inline void timer_wheel_advance(TimerWheel *w)
+{
+    w->now = w->level_count[0] ? w->now + 1 : (w->now | WHEEL_MASK) + 1;
+    for (int level = 1; level < WHEEL_LEVELS; level++) { // 아래 단계가 한 바퀴 돌았으면 윗 단계 칸을 내림
+        if (w->now & ((1u << (WHEEL_BITS * level)) - 1)) break;
+        timer_wheel_cascade(w, level, (int)((w->now >> (WHEEL_BITS * level)) & WHEEL_MASK));
+    }
+}
+
+// 가장 이른 이벤트를 꺼내 번호 반환 (없으면 -1), *t 에 시각
+static inline int timer_wheel_pop(TimerWheel *w, uint32_t *t)
+{
+    if (w->count == 0) return -1;
+    while (1) {
+        int slot = (int)(w->now & WHEEL_MASK);
+        int event = w->head[0][slot];
+        if (event >= 0) {
+            w->head[0][slot] = w->next[event];
+            if (w->head[0][slot] < 0) w->tail[0][slot] = -1;
+            w->level_count[0]--;
+            w->count--;
+            *t = w->time[event];
+            return event;
+        }
+        timer_wheel_advance(w);
+    }
+}
+
+#endif